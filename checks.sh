@@ -79,6 +79,265 @@ right='LICENSE: urn:bitprint:4OCVQYAJ5WN5EOFWN32A5YLYN7673TNS.ZXJHEQJAFI2DN5LPRG
 res=$($bitprint LICENSE)
 check 9 "$res" "$right"
 
+# Multiple leaves: 3890 and 108890 bytes of text
+lines() {
+  awk "BEGIN { for (i = 0; i < $1; i++) print i }"
+}
+
+right='urn:bitprint:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP.JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCY'
+res=$(lines 1000 | $bitprint)
+check 10 "$res" "$right"
+
+right='urn:bitprint:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA.CR7IVLEM6YIYMG757P4GEXP6XLOGNVLV2SXERQY'
+res=$(lines 20000 | $bitprint)
+check 11 "$res" "$right"
+
+# The portable kernel must agree with whatever was selected
+res=$(lines 20000 | BITTER_KERNELS=tiger=scalar $bitprint)
+check 12 "$res" "$right"
+
+# Plain Tiger hash of the whole input
+right='/dev/null: urn:tiger:GKJ2YYYMCPYCIX4SXOYXM3QWCZ5E4WCJFXPHH4Y'
+res=$(${executable} -t /dev/null)
+check 13 "$res" "$right"
+
+right='urn:tiger:FKVRJBHIYFMPFP5YYX7UDNL2KJISSEY4SV5V7EY'
+res=$(printf "abc" | ${executable} -t)
+check 14 "$res" "$right"
+
+# Tiger hash and TTH from the same pass
+right='urn:tree:tiger:CR7IVLEM6YIYMG757P4GEXP6XLOGNVLV2SXERQY
+urn:tiger:JXVEFJYQO3OCITXTZRAZIE26JUYGZPUA7TTAYKA'
+res=$(lines 20000 | ${executable} -T -t)
+check 15 "$res" "$right"
+
+# Leaves split across reads of odd sizes
+right='urn:tree:tiger:CR7IVLEM6YIYMG757P4GEXP6XLOGNVLV2SXERQY'
+res=$(lines 20000 | dd bs=1000 2>/dev/null | $tth)
+check 16 "$res" "$right"
+
+# Parallel TTH of a regular file of more than two subtrees (2688890 bytes)
+tmp_file="${TMPDIR:-/tmp}/bitter-checks.$$"
+lines 400000 > "${tmp_file}"
+right='urn:tree:tiger:EUQTA4R4247MD3O2FZM47AQOPKNZ7CTFWTMBLNQ'
+res=$($tth -q -j 3 "${tmp_file}")
+rm -f -- "${tmp_file}"
+check 17 "$res" "$right"
+
+# The same over a pipe, hashed by a pool of threads
+res=$(lines 400000 | $tth -j 3)
+check 18 "$res" "$right"
+
+# SHA-1 of several blocks with the selected and with the portable kernel
+right='urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA'
+res=$(lines 20000 | $sha1)
+check 19 "$res" "$right"
+
+res=$(lines 20000 | BITTER_KERNELS=sha1=scalar $sha1)
+check 20 "$res" "$right"
+
+# Small files are hashed together, the results must stay in order
+lines 1000 > "${tmp_file}.1"
+lines 20000 > "${tmp_file}.2"
+right='urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP'
+res=$($sha1 -q "${tmp_file}.1" "${tmp_file}.2" "${tmp_file}.1")
+rm -f -- "${tmp_file}.1" "${tmp_file}.2"
+check 21 "$res" "$right"
+
+# SHA-1 and TTH of a file too small for the parallel TTH on two threads
+lines 100000 > "${tmp_file}"
+right='urn:bitprint:5L5MNLXF2MFEQKKFL2Z4ON6F77KKXNLS.JFZWHHG4CUJSSVMNJ6A54VQAUHPZVVNKIHMKOTA'
+res=$($bitprint -q -j 2 "${tmp_file}")
+rm -f -- "${tmp_file}"
+check 22 "$res" "$right"
+
+# A regular file on the standard input is hashed from memory mappings
+# or read with io_uring, starting at the current file offset
+lines 400000 > "${tmp_file}"
+right='urn:bitprint:W3JCS5NL27QHI2QHXLGG7RIOODHCL3FI.EUQTA4R4247MD3O2FZM47AQOPKNZ7CTFWTMBLNQ'
+res=$($bitprint -Q 0 < "${tmp_file}")
+check 23 "$res" "$right"
+
+right='urn:tree:tiger:I3PFF2RSMXLQMK7OPIUN7PYCJVZQE7ABMPSEBCQ'
+res=$({ dd bs=1001 count=1 >/dev/null 2>&1; $tth; } < "${tmp_file}")
+check 24 "$res" "$right"
+
+# Fewer slots than blocks, they must be hashed in order
+right='urn:bitprint:W3JCS5NL27QHI2QHXLGG7RIOODHCL3FI.EUQTA4R4247MD3O2FZM47AQOPKNZ7CTFWTMBLNQ'
+res=$($bitprint -q -Q 3 "${tmp_file}")
+check 25 "$res" "$right"
+
+# Past the page cache; the offset on the standard input is not aligned
+res=$($bitprint -q -N "${tmp_file}")
+check 26 "$res" "$right"
+
+right='urn:tree:tiger:I3PFF2RSMXLQMK7OPIUN7PYCJVZQE7ABMPSEBCQ'
+res=$({ dd bs=1001 count=1 >/dev/null 2>&1; $tth -N; } < "${tmp_file}")
+rm -f -- "${tmp_file}"
+check 27 "$res" "$right"
+
+# The reads of a batch overtake each other with a deeper queue
+lines 1000 > "${tmp_file}.1"
+lines 20000 > "${tmp_file}.2"
+right='urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP'
+res=$($sha1 -q -Q 2 "${tmp_file}.1" "${tmp_file}.2" "${tmp_file}.1")
+rm -f -- "${tmp_file}.1" "${tmp_file}.2"
+check 28 "$res" "$right"
+
+# Several files at once, a missing one must not stop the others
+lines 1000 > "${tmp_file}.1"
+lines 20000 > "${tmp_file}.2"
+right='urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+failed'
+res=$($sha1 -q -j 3 "${tmp_file}.1" "${tmp_file}.2" "${tmp_file}.3" \
+        "${tmp_file}.1" 2>/dev/null || echo failed)
+rm -f -- "${tmp_file}.1" "${tmp_file}.2"
+check 29 "$res" "$right"
+
+# Idle threads steal subtrees of the TTH of a large file from the back
+lines 400000 > "${tmp_file}"
+lines 1000 > "${tmp_file}.1"
+right='urn:bitprint:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP.JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCY
+urn:bitprint:W3JCS5NL27QHI2QHXLGG7RIOODHCL3FI.EUQTA4R4247MD3O2FZM47AQOPKNZ7CTFWTMBLNQ
+urn:bitprint:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP.JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCY'
+res=$($bitprint -q -j 4 "${tmp_file}.1" "${tmp_file}" "${tmp_file}.1")
+rm -f -- "${tmp_file}" "${tmp_file}.1"
+check 30 "$res" "$right"
+
+# A directory tree, the second link of a file takes the result of the first
+mkdir -p "${tmp_file}.d/sub"
+lines 1000 > "${tmp_file}.d/1"
+lines 20000 > "${tmp_file}.d/sub/2"
+ln "${tmp_file}.d/1" "${tmp_file}.d/sub/3"
+right='urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP'
+res=$($sha1 -q -r -j 3 "${tmp_file}.d" | sort)
+rm -rf -- "${tmp_file}.d"
+check 31 "$res" "$right"
+
+# A list of files separated by NUL characters, names may contain spaces
+lines 1000 > "${tmp_file} 1"
+lines 20000 > "${tmp_file}.2"
+right='urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP'
+res=$(printf '%s\0' "${tmp_file} 1" "${tmp_file}.2" "${tmp_file} 1" |
+        $sha1 -q -j 2 -0 -F -)
+rm -f -- "${tmp_file} 1" "${tmp_file}.2"
+check 32 "$res" "$right"
+
+# Regular files of one leaf, one leaf and a byte and of 108890 bytes are
+# hashed from a single read
+lines 20000 | head -c 1024 > "${tmp_file}.1"
+lines 20000 | head -c 1025 > "${tmp_file}.2"
+lines 20000 > "${tmp_file}.3"
+right='urn:tree:tiger:DF4EQAVC6WQER6WFS2NVQKXQ6ZG3SMTIQDNUBZA
+urn:tiger:O2UG5GACGXYT6QNWOBUIXAMMWRNKXZBOL7A6FRQ
+urn:tree:tiger:WC5NK6DG2GRMEAHKJDJCTPTL42RJ6J75DRHPEZQ
+urn:tiger:IDRQJUXI7JGGIF3V725MD3RCB5BGEBLNCTTCHJQ
+urn:tree:tiger:CR7IVLEM6YIYMG757P4GEXP6XLOGNVLV2SXERQY
+urn:tiger:JXVEFJYQO3OCITXTZRAZIE26JUYGZPUA7TTAYKA'
+res=$(${executable} -q -T -t "${tmp_file}.1" "${tmp_file}.2" "${tmp_file}.3")
+rm -f -- "${tmp_file}.1" "${tmp_file}.2" "${tmp_file}.3"
+check 33 "$res" "$right"
+
+# A cached file gives the same result and a changed one is hashed again
+lines 1000 > "${tmp_file}.1"
+right='urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP
+urn:sha1:XIXEJ3OTX44GSHUDKKEQH7FB27K6Q7VA'
+res=$($sha1 -q -k "${tmp_file}.db" "${tmp_file}.1" &&
+        $sha1 -q -k "${tmp_file}.db" "${tmp_file}.1" &&
+        lines 20000 > "${tmp_file}.1" &&
+        $sha1 -q -k "${tmp_file}.db" "${tmp_file}.1")
+rm -f -- "${tmp_file}.1" "${tmp_file}.db"
+check 34 "$res" "$right"
+
+# Checking results: a match, a mismatch and a missing file
+lines 1000 > "${tmp_file}.1"
+right="${tmp_file}.1: OK
+${tmp_file}.1: FAILED
+${tmp_file}.2: MISSING
+1"
+res=$(printf '%s: %s\n' \
+        "${tmp_file}.1" 'urn:bitprint:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP.JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCY' \
+        "${tmp_file}.1" 'urn:tree:tiger:CR7IVLEM6YIYMG757P4GEXP6XLOGNVLV2SXERQY' \
+        "${tmp_file}.2" 'urn:sha1:XQ7U4FNNFDAO7E2CBZYUOH4MGSJEQYVP' |
+        ${executable} -j 2 -C - 2>/dev/null; echo $?)
+rm -f -- "${tmp_file}.1"
+check 35 "$res" "$right"
+
+# The THEX tree of 4 leaves at depth 2: the root and the TTH of each half
+lines 1000 > "${tmp_file}.1"
+right='urn:tree:tiger:JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCY
+thex:2:JMOKOREC6ZYTODTTT5B2MBSGX6KECV2NOOP6GCZJSTLAMVKALGOCEUDLKQLO5JF6NNSV4C6FK5WCWDJPIFEVTV722FXXLM2HSY4HUGU5CNFEEYOR7LOQ===='
+res=$($tth -q -X 2 "${tmp_file}.1")
+rm -f -- "${tmp_file}.1"
+check 36 "$res" "$right"
+
+# Verifying against a THEX tree: intact, then with two corrupt leaves
+lines 1000 > "${tmp_file}.1"
+$tth -X 3 "${tmp_file}.1" > "${tmp_file}.tree"
+right="${tmp_file}.1: OK
+${tmp_file}.1: FAILED 1024-3071
+1"
+res=$(${executable} -R "${tmp_file}.tree" "${tmp_file}.1" 2>/dev/null &&
+        printf 'xx' | dd of="${tmp_file}.1" bs=1 seek=2047 conv=notrunc \
+          2>/dev/null &&
+        ${executable} -j 2 -R "${tmp_file}.tree" "${tmp_file}.1" 2>/dev/null;
+        echo $?)
+rm -f -- "${tmp_file}.1" "${tmp_file}.tree"
+check 37 "$res" "$right"
+
+# More small files than may be open at once
+mkdir -p "${tmp_file}.d"
+awk "BEGIN { for (i = 0; i < 300; i++) print i > \"${tmp_file}.d/\" i }"
+right='300'
+res=$(ulimit -n 32 && $sha1 -q -j 2 "${tmp_file}.d"/* | sort -u | wc -l)
+check 38 "$res" "$right"
+
+# Likewise with the cache, which must not keep the files open either
+res=$(ulimit -n 32 &&
+        $sha1 -q -Q 0 -k "${tmp_file}.db" "${tmp_file}.d"/* | sort -u | wc -l)
+rm -rf -- "${tmp_file}.d" "${tmp_file}.db"
+check 39 "$res" "$right"
+
+# The roots of the segments hashed for -R match the -X tree at the bottom
+# level and higher up, for sizes around the leaf boundaries
+res=$(for size in 0 1023 1024 1025 2047 2048 2049 4096 4097 5121; do
+        lines 1000 | head -c $size > "${tmp_file}.1"
+        for depth in 2 3 20; do
+          $tth -X $depth "${tmp_file}.1" > "${tmp_file}.tree" &&
+            ${executable} -R "${tmp_file}.tree" "${tmp_file}.1" 2>/dev/null
+        done
+      done | grep -c ': OK$')
+right='30'
+rm -f -- "${tmp_file}.1" "${tmp_file}.tree"
+check 40 "$res" "$right"
+
+# Every link of a file is listed, so the results of -r check out with -C
+mkdir -p "${tmp_file}.a" "${tmp_file}.b"
+lines 1000 > "${tmp_file}.a/x"
+lines 20000 > "${tmp_file}.a/z"
+ln "${tmp_file}.a/x" "${tmp_file}.b/y"
+right="${tmp_file}.a/x
+${tmp_file}.a/z
+${tmp_file}.b/y
+3 OK, 0 FAILED, 0 MISSING
+0"
+res=$($bitprint -r -j 2 "${tmp_file}.a" "${tmp_file}.b" > "${tmp_file}.list"
+        sed 's/: urn:.*//' "${tmp_file}.list" | sort
+        ${executable} -q -C "${tmp_file}.list" 2>&1; echo $?)
+rm -rf -- "${tmp_file}.a" "${tmp_file}.b" "${tmp_file}.list"
+check 41 "$res" "$right"
+
 echo "ALL ${last_check} CHECKS PASSED"
 exit
 
@@ -454,11 +454,17 @@ show_help() {
   if [ "x${use_large_files}" != x ]; then
     msg '  --disable-large-files  Disable explicit large file support.'
   fi
+  if [ "x${use_simd}" != x ]; then
+    msg '  --disable-simd       Do not use SIMD instructions even if supported.'
+  fi
   if [ "x${use_poll}" != x ]; then
     msg '  --use-poll           Use poll() instead of kqueue() or epoll().'
   fi
   if [ "x${use_threads}" != x ]; then
-    msg '  --use-threads        Use POSIX threads (if available).'
+    msg '  --disable-threads    Do not use POSIX threads even if available.'
+  fi
+  if [ "x${use_io_uring}" != x ]; then
+    msg '  --disable-io-uring   Do not use io_uring even if available.'
   fi
   if [ "x${use_gethostbyname}" != x ]; then
     msg '  --use-gethostbyname  Use gethostbyname() instead of getaddrinfo().'
@@ -466,6 +472,9 @@ show_help() {
   if [ "x${use_sha1}" != x ]; then
     msg '  --use-sha1  Use SHA-1 calculation routines.'
   fi
+  if [ "x${use_builtin_sha1}" != x ]; then
+    msg '  --disable-builtin-sha1  Use the SHA-1 of the system libraries.'
+  fi
   if [ "x${use_sqlite3}" != x ]; then
     msg '  --use-sqlite3  Use SQLite3.'
   fi
@@ -479,9 +488,12 @@ handle_vars() {
     library_dir \
     prefix \
     use_gethostbyname \
+    use_builtin_sha1 \
+    use_io_uring \
     use_ipv6 \
     use_poll \
     use_sha1 \
+    use_simd \
     use_socker \
     use_sqlite3 \
     use_threads \
@@ -530,6 +542,9 @@ handle_args() {
       --disable-large-files)
         unset use_large_files
       ;;
+      --disable-simd)
+        unset use_simd
+      ;;
       --use-gethostbyname)
         use_gethostbyname=1
       ;;
@@ -539,6 +554,15 @@ handle_args() {
       --use-threads)
         use_threads=1
       ;;
+      --disable-threads)
+        unset use_threads
+      ;;
+      --use-io-uring)
+        use_io_uring=1
+      ;;
+      --disable-io-uring)
+        unset use_io_uring
+      ;;
       --disable-socker)
         unset use_socker
       ;;
@@ -551,6 +575,12 @@ handle_args() {
       --use-sha1)
         use_sha1=1
       ;;
+      --disable-builtin-sha1)
+        unset use_builtin_sha1
+      ;;
+      --use-builtin-sha1)
+        use_builtin_sha1=1
+      ;;
       --disable-sqlite3)
         unset use_sqlite3
       ;;
@@ -689,6 +719,12 @@ config_test_h_def 'HAVE_NETDB_H'
 check_std_header 'HAVE_FEATURES_H' 'features.h'
 config_test_h_def 'HAVE_FEATURES_H'
 
+check_std_header 'HAVE_CPUID_H' 'cpuid.h'
+config_test_h_def 'HAVE_CPUID_H'
+
+check_std_header 'HAVE_GETOPT_H' 'getopt.h'
+config_test_h_def 'HAVE_GETOPT_H'
+
 check_have_type 'HAVE_INT8_T' 'int8_t'
 config_test_h_def 'HAVE_INT8_T'
 
@@ -1028,6 +1064,25 @@ config_test_compile_and_link 'HAVE_CLOCK_GETTIME'
 msg_yes_no $?
 unset try_libs
 
+if [ "x${HAVE_GETOPT_H}" != x ]; then
+  msg_printf 'Looking for getopt_long()... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <getopt.h>
+int
+main(int argc, char *argv[]) {
+  static const struct option options[] = {
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  return -1 != getopt_long(argc, argv, "h", options, NULL);
+}
+EOF
+  config_test_compile_and_link 'HAVE_GETOPT_LONG'
+  msg_yes_no $?
+else
+  clear_var HAVE_GETOPT_LONG
+fi
 
 msg_printf 'Looking for uname()... '
 echo '#include <sys/utsname.h>' >> config_test.h 
@@ -1331,6 +1386,155 @@ else
   clear_var HAVE_PTHREAD_SUPPORT
 fi
 
+if [ "x${use_io_uring}" != x ]; then
+  msg_printf 'Looking for io_uring... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+int
+main(void)
+{
+  static struct io_uring_params p;
+  static struct io_uring_sqe sqe;
+
+  sqe.opcode = IORING_OP_READ_FIXED;
+  return syscall(__NR_io_uring_setup, 1, &p) < 0 && 0 != sqe.opcode;
+}
+EOF
+  config_test_compile_and_link 'HAVE_IO_URING'
+  msg_yes_no $?
+else
+  clear_var HAVE_IO_URING
+fi
+
+msg_printf 'Looking for O_DIRECT... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <fcntl.h>
+
+int
+main(void)
+{
+  return open("", O_RDONLY | O_DIRECT) >= 0;
+}
+EOF
+config_test_compile_and_link 'HAVE_O_DIRECT'
+if [ "x${HAVE_O_DIRECT}" != x ]; then
+  msg_yes
+else
+  # glibc defines O_DIRECT only with _GNU_SOURCE
+  saved_cflags=${CFLAGS}
+  CFLAGS="${CFLAGS} -D_GNU_SOURCE"
+  config_test_compile_and_link 'HAVE_O_DIRECT'
+  if [ "x${HAVE_O_DIRECT}" != x ]; then
+    msg_yes
+  else
+    CFLAGS=${saved_cflags}
+    msg_no
+  fi
+fi
+
+msg_printf 'Looking for sched_getaffinity()... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <sched.h>
+
+int
+main(void)
+{
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  return sched_getaffinity(0, sizeof set, &set) ? 0 : CPU_COUNT(&set);
+}
+EOF
+config_test_compile_and_link 'HAVE_SCHED_GETAFFINITY'
+msg_yes_no $?
+
+msg_printf 'Looking for getdents64()... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <dirent.h>
+
+int
+main(void)
+{
+  static char buf[4096];
+  const struct dirent64 *d = (const void *) buf;
+
+  return getdents64(0, buf, sizeof buf) > 0 ? d->d_reclen : 0;
+}
+EOF
+config_test_compile_and_link 'HAVE_GETDENTS64'
+msg_yes_no $?
+
+msg_printf 'Looking for statx()... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+int
+main(void)
+{
+  struct statx stx;
+
+  return statx(AT_FDCWD, ".", AT_STATX_DONT_SYNC, STATX_INO, &stx);
+}
+EOF
+config_test_compile_and_link 'HAVE_STATX'
+msg_yes_no $?
+
+msg_printf 'Looking for st_mtim in struct stat... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <sys/stat.h>
+
+int
+main(void)
+{
+  struct stat sb;
+
+  return stat(".", &sb) ? 0 : sb.st_mtim.tv_nsec + sb.st_ctim.tv_nsec > 0;
+}
+EOF
+config_test_compile_and_link 'HAVE_ST_MTIM'
+msg_yes_no $?
+
+msg_printf 'Looking for posix_fallocate()... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <fcntl.h>
+
+int
+main(void)
+{
+  return posix_fallocate(-1, 0, 4096);
+}
+EOF
+config_test_compile_and_link 'HAVE_POSIX_FALLOCATE'
+msg_yes_no $?
+
+msg_printf 'Looking for fgetxattr()... '
+cat > config_test.c <<EOF
+#include "config_test.h"
+#include <sys/types.h>
+#include <sys/xattr.h>
+
+int
+main(void)
+{
+  static char buf[64];
+
+  return fgetxattr(0, "user.test", buf, sizeof buf) > 0 &&
+    0 == fsetxattr(0, "user.test", buf, sizeof buf, 0);
+}
+EOF
+config_test_compile_and_link 'HAVE_FGETXATTR'
+msg_yes_no $?
+
 link_libdl=
 if [ "x${use_dlopen}" != x ]; then
   msg_printf 'Looking for dlopen()... '
@@ -1422,6 +1626,107 @@ config_test_c_compile 'HAVE_LITTLE_ENDIAN'
 msg_yes_no $?
 
 
+if [ "x${use_simd}" != x ]; then
+  msg_printf 'Looking for AVX2 intrinsics... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <immintrin.h>
+
+static __attribute__((__target__("avx2"))) long long
+func(const long long *p)
+{
+  __m256i v = _mm256_i64gather_epi64(p, _mm256_set1_epi64x(1), 8);
+  return _mm256_extract_epi64(_mm256_add_epi64(v, v), 0);
+}
+
+int
+main(void)
+{
+  static long long data[4];
+  return __builtin_cpu_supports("avx2") ? 0 != func(data) : 0;
+}
+EOF
+  config_test_compile_and_link 'HAVE_AVX2_INTRINSICS'
+  msg_yes_no $?
+
+  msg_printf 'Looking for AVX-512 intrinsics... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <immintrin.h>
+
+static __attribute__((__target__("avx512f"))) long long
+func(const long long *p)
+{
+  __m512i v = _mm512_i64gather_epi64(_mm512_set1_epi64(1), p, 8);
+  return _mm512_reduce_add_epi64(_mm512_add_epi64(v, v));
+}
+
+int
+main(void)
+{
+  static long long data[8];
+  return __builtin_cpu_supports("avx512f") ? 0 != func(data) : 0;
+}
+EOF
+  config_test_compile_and_link 'HAVE_AVX512_INTRINSICS'
+  msg_yes_no $?
+
+  msg_printf 'Looking for SSSE3 intrinsics... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <immintrin.h>
+
+static __attribute__((__target__("ssse3"))) int
+func(const void *p)
+{
+  __m128i v = _mm_loadu_si128(p);
+  v = _mm_alignr_epi8(_mm_shuffle_epi8(v, v), v, 8);
+  return _mm_cvtsi128_si32(v);
+}
+
+int
+main(void)
+{
+  static char data[16];
+  return __builtin_cpu_supports("ssse3") ? 0 != func(data) : 0;
+}
+EOF
+  config_test_compile_and_link 'HAVE_SSSE3_INTRINSICS'
+  msg_yes_no $?
+
+  msg_printf 'Looking for SHA intrinsics... '
+  cat > config_test.c <<EOF
+#include "config_test.h"
+#include <immintrin.h>
+
+static __attribute__((__target__("sha,ssse3"))) int
+func(const void *p)
+{
+  __m128i v = _mm_loadu_si128(p);
+  v = _mm_sha1rnds4_epu32(v, _mm_sha1nexte_epu32(v, v), 0);
+  v = _mm_sha1msg2_epu32(_mm_sha1msg1_epu32(v, v), v);
+  return _mm_cvtsi128_si32(v);
+}
+
+int
+main(int argc, char *argv[])
+{
+  static char data[16];
+  (void) argv;
+  /* Never executed, the compiler might not know about "sha" */
+  return argc > 1000 ? 0 != func(data) : 0;
+}
+EOF
+  config_test_compile_and_link 'HAVE_SHA_INTRINSICS'
+  msg_yes_no $?
+else
+  clear_var HAVE_AVX2_INTRINSICS
+  clear_var HAVE_AVX512_INTRINSICS
+  clear_var HAVE_SSSE3_INTRINSICS
+  clear_var HAVE_SHA_INTRINSICS
+fi
+
+
 msg_printf 'Looking for sockaddr_un.sun_len ... '
 cat > config_test.c <<EOF
 #include "config_test.h"
@@ -1553,6 +1858,7 @@ unset saved_ldflags
 fi # use_socker
 
 HAVE_SHA1=
+HAVE_BUILTIN_SHA1=
 HAVE_NETBSD_SHA1=
 HAVE_OPENBSD_SHA1=
 HAVE_FREEBSD_SHA1=
@@ -1561,6 +1867,11 @@ HAVE_BEECRYPT_SHA1=
 
 if [ "x${use_sha1}" != x ]; then
 
+if [ "x${use_builtin_sha1}" != x ]; then
+HAVE_SHA1=1
+HAVE_BUILTIN_SHA1=1
+fi
+
 if [ "x${HAVE_SHA1}" = x ]; then
 msg_printf 'Looking for NetBSD SHA-1 functions... '
 cat > config_test.c <<EOF
@@ -1722,8 +2033,18 @@ config_h_def 'HAVE_NETINET_IN_H'
 config_h_def 'HAVE_ARPA_INET_H'
 config_h_def 'HAVE_NETDB_H'
 config_h_def 'HAVE_FEATURES_H'
+config_h_def 'HAVE_CPUID_H'
+config_h_def 'HAVE_GETOPT_H'
 config_h_def 'HAVE_PTHREAD_H'
 config_h_def 'HAVE_PTHREAD_SUPPORT'
+config_h_def 'HAVE_IO_URING'
+config_h_def 'HAVE_O_DIRECT'
+config_h_def 'HAVE_SCHED_GETAFFINITY'
+config_h_def 'HAVE_GETDENTS64'
+config_h_def 'HAVE_STATX'
+config_h_def 'HAVE_ST_MTIM'
+config_h_def 'HAVE_POSIX_FALLOCATE'
+config_h_def 'HAVE_FGETXATTR'
 
 # Types
 config_h_def 'HAVE_INT8_T'
@@ -1765,6 +2086,7 @@ config_h_def 'HAVE___inline'
 config_h_def 'HAVE_BEECRYPT_SHA1'
 config_h_def 'HAVE_BIND_WITH_STRUCT_SOCKADDR'
 config_h_def 'HAVE_BSD_STRUCT_RUSAGE'
+config_h_def 'HAVE_BUILTIN_SHA1'
 config_h_def 'HAVE_CLOCK_GETTIME'
 config_h_def 'HAVE_DBOPEN'
 config_h_def 'HAVE_EPOLL'
@@ -1774,6 +2096,7 @@ config_h_def 'HAVE_FREEBSD_SHA1'
 config_h_def 'HAVE_GAI_STRERROR'
 config_h_def 'HAVE_GETADDRINFO'
 config_h_def 'HAVE_GETHOSTBYNAME'
+config_h_def 'HAVE_GETOPT_LONG'
 config_h_def 'HAVE_GETPAGESIZE'
 config_h_def 'HAVE_GETRUSAGE'
 config_h_def 'HAVE_HERROR'
@@ -1789,8 +2112,12 @@ config_h_def 'HAVE_SQLITE3'
 config_h_def 'HAVE_UNAME'
 
 # Definitions and enums
+config_h_def 'HAVE_AVX2_INTRINSICS'
+config_h_def 'HAVE_AVX512_INTRINSICS'
 config_h_def 'HAVE_BIG_ENDIAN'
 config_h_def 'HAVE_LITTLE_ENDIAN'
+config_h_def 'HAVE_SHA_INTRINSICS'
+config_h_def 'HAVE_SSSE3_INTRINSICS'
 config_h_def 'HAVE_MSG_MORE'
 config_h_def 'HAVE_SHUT_RD'
 config_h_def 'HAVE_SHUT_RDWR'
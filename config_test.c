@@ -0,0 +1,6 @@
+#include "config_test.h"
+int main(void)
+{
+
+  return 0;
+}
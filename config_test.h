@@ -0,0 +1,63 @@
+#ifdef __TenDRA__
+#pragma TenDRA longlong type allow
+#endif /* __TenDRA__ */
+#include <sys/types.h>
+#define HAVE_SYS_TYPES_H 1
+#include <inttypes.h>
+#define HAVE_INTTYPES_H 1
+#include <stdbool.h>
+#define HAVE_STDBOOL_H 1
+#include <stdlib.h>
+#define HAVE_STDLIB_H 1
+#include <sys/param.h>
+#define HAVE_SYS_PARAM_H 1
+#undef HAVE_SYS_ENDIAN_H
+#include <sys/socket.h>
+#define HAVE_SYS_SOCKET_H 1
+#undef HAVE_SYS_EVENT_H
+#include <sys/time.h>
+#define HAVE_SYS_TIME_H 1
+#include <sys/un.h>
+#define HAVE_SYS_UN_H 1
+#include <netinet/in.h>
+#define HAVE_NETINET_IN_H 1
+#include <arpa/inet.h>
+#define HAVE_ARPA_INET_H 1
+#include <pthread.h>
+#define HAVE_PTHREAD_H 1
+#include <netdb.h>
+#define HAVE_NETDB_H 1
+#define HAVE_FEATURES_H 1
+#define HAVE_CPUID_H 1
+#define HAVE_GETOPT_H 1
+#define HAVE_INT8_T 1
+#define HAVE_UINT8_T 1
+#define HAVE_INT16_T 1
+#define HAVE_UINT16_T 1
+#define HAVE_INT32_T 1
+#define HAVE_UINT32_T 1
+#define HAVE_INT64_T 1
+#define HAVE_UINT64_T 1
+#define HAVE_INTMAX_T 1
+#define HAVE_UINTMAX_T 1
+#define HAVE_INTPTR_T 1
+#define HAVE_UINTPTR_T 1
+#define HAVE_SOCKLEN_T 1
+#define HAVE_IN_ADDR_T 1
+#undef HAVE_PORT_T
+#define SIZEOF_CHAR 1
+#define SIZEOF_SHORT 2
+#define SIZEOF_INT 4
+#define SIZEOF_LONG 8
+#define SIZEOF_LONG_LONG 8
+#define SIZEOF_UINTMAX_T 8
+#define SIZEOF_UINTPTR_T 8
+#define SIZEOF_VOID_PTR 8
+#define SIZEOF_BOOL 1
+#define SIZEOF_SIZE_T 8
+#define SIZEOF_OFF_T 8
+#define HAVE_C99_func 1
+#include <unistd.h>
+#include <signal.h>
+#include <sys/utsname.h>
+#include <sys/resource.h>
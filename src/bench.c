@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Compares the throughput of the bitprint (SHA-1 and TTH) calculated in
+ * two passes over each buffer read, as bitter did originally, with the
+ * fused loop of bitprint_update(). The data is generated in memory so
+ * that only the hashing is measured.
+ */
+
+#include "lib/common.h"
+#include "lib/bitprint.h"
+#include "lib/kernel.h"
+
+#define BENCH_READ (32 * 1024) /* buffer size of get_sums() */
+#define BENCH_RUNS 5
+
+static double
+bench_now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+bench_two_pass(const char *data, size_t size,
+  struct sha1 *sha1, char tth[TIGERSIZE])
+{
+  struct compat_sha1 sha1_ctx;
+  TT_CONTEXT tt_ctx;
+  size_t i;
+
+  compat_sha1_init(&sha1_ctx);
+  tt_init(&tt_ctx);
+  for (i = 0; i < size; i += BENCH_READ) {
+    size_t n = MIN(size - i, BENCH_READ);
+
+    compat_sha1_update(&sha1_ctx, &data[i], n);
+    tt_update(&tt_ctx, &data[i], n);
+  }
+  compat_sha1_final(&sha1_ctx, sha1);
+  tt_digest(&tt_ctx, tth);
+}
+
+static void
+bench_fused(const char *data, size_t size,
+  struct sha1 *sha1, char tth[TIGERSIZE])
+{
+  struct compat_sha1 sha1_ctx;
+  TT_CONTEXT tt_ctx;
+  size_t i;
+
+  compat_sha1_init(&sha1_ctx);
+  tt_init(&tt_ctx);
+  for (i = 0; i < size; i += BENCH_READ) {
+    size_t n = MIN(size - i, BENCH_READ);
+
+    bitprint_update(&sha1_ctx, &tt_ctx, NULL, &data[i], n);
+  }
+  compat_sha1_final(&sha1_ctx, sha1);
+  tt_digest(&tt_ctx, tth);
+}
+
+/**
+ * @return the best throughput of BENCH_RUNS runs in MB/s.
+ */
+static double
+bench_run(void (*func)(const char *, size_t, struct sha1 *, char *),
+  const char *data, size_t size, struct sha1 *sha1, char tth[TIGERSIZE])
+{
+  double best = 0.0;
+  unsigned i;
+
+  for (i = 0; i < BENCH_RUNS; i++) {
+    double t = bench_now();
+
+    func(data, size, sha1, tth);
+    t = bench_now() - t;
+    if (t > 0.0) {
+      best = MAX(best, size / t / 1000000.0);
+    }
+  }
+  return best;
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct sha1 sha1[2];
+  char tth[2][TIGERSIZE];
+  double two_pass, fused;
+  uint32_t x = 1;
+  size_t size, i;
+  char *data;
+
+  size = (argc > 1 ? (size_t) atoi(argv[1]) : 64) * 1024 * 1024;
+  data = malloc(size);
+  if (NULL == data) {
+    fprintf(stderr, "malloc(): %s\n", compat_strerror(errno));
+    return EXIT_FAILURE;
+  }
+  for (i = 0; i < size; i++) {
+    x = x * 1103515245UL + 12345;
+    data[i] = x >> 24;
+  }
+
+  kernels_init();
+  kernels_report(stdout);
+
+  two_pass = bench_run(bench_two_pass, data, size, &sha1[0], tth[0]);
+  fused = bench_run(bench_fused, data, size, &sha1[1], tth[1]);
+  if (
+    0 != memcmp(&sha1[0], &sha1[1], sizeof sha1[0]) ||
+    0 != memcmp(tth[0], tth[1], sizeof tth[0])
+  ) {
+    fprintf(stderr, "bench: the results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("bitprint of %lu MiB in %u KiB reads:\n",
+    (unsigned long) (size / 1024 / 1024), BENCH_READ / 1024);
+  printf("  two passes: %7.1f MB/s\n", two_pass);
+  printf("  fused (%u KiB blocks): %7.1f MB/s (%+.1f%%)\n",
+    BITPRINT_BLOCK / 1024, fused, (fused / two_pass - 1.0) * 100.0);
+
+  free(data);
+  return 0;
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
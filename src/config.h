@@ -0,0 +1,109 @@
+#ifndef CONFIG_HEADER_FILE
+#define CONFIG_HEADER_FILE
+
+#ifdef __TenDRA__
+#pragma TenDRA longlong type allow
+#endif /* __TenDRA__ */
+#define HAVE_INTTYPES_H 1
+#define HAVE_STDBOOL_H 1
+#define HAVE_STDLIB_H 1
+#define HAVE_SYS_PARAM_H 1
+#define HAVE_SYS_SOCKET_H 1
+#undef HAVE_SYS_EVENT_H
+#define HAVE_SYS_TIME_H 1
+#define HAVE_SYS_UN_H 1
+#define HAVE_NETINET_IN_H 1
+#define HAVE_ARPA_INET_H 1
+#define HAVE_NETDB_H 1
+#define HAVE_FEATURES_H 1
+#define HAVE_CPUID_H 1
+#define HAVE_GETOPT_H 1
+#define HAVE_PTHREAD_H 1
+#define HAVE_PTHREAD_SUPPORT 1
+#define HAVE_IO_URING 1
+#define HAVE_O_DIRECT 1
+#define HAVE_SCHED_GETAFFINITY 1
+#define HAVE_GETDENTS64 1
+#define HAVE_STATX 1
+#define HAVE_ST_MTIM 1
+#define HAVE_POSIX_FALLOCATE 1
+#define HAVE_FGETXATTR 1
+#define HAVE_INT8_T 1
+#define HAVE_INT16_T 1
+#define HAVE_INT32_T 1
+#define HAVE_INT64_T 1
+#define HAVE_INTMAX_T 1
+#define HAVE_INTPTR_T 1
+#define HAVE_IN_ADDR_T 1
+#define HAVE_IN_PORT_T 1
+#define HAVE_SOCKLEN_T 1
+#define HAVE_UINT8_T 1
+#define HAVE_UINT16_T 1
+#define HAVE_UINT32_T 1
+#define HAVE_UINT64_T 1
+#define HAVE_UINTMAX_T 1
+#define HAVE_UINTPTR_T 1
+#define SIZEOF_BOOL 1
+#define SIZEOF_CHAR 1
+#define SIZEOF_INT 4
+#define SIZEOF_LONG 8
+#define SIZEOF_LONG_LONG 8
+#define SIZEOF_OFF_T 8
+#define SIZEOF_SHORT 2
+#define SIZEOF_SIZE_T 8
+#define SIZEOF_UINTMAX_T 8
+#define SIZEOF_UINTPTR_T 8
+#define SIZEOF_VOID_PTR 8
+#define HAVE_C99_VARIADIC_MACROS 1
+#define HAVE_C99_func 1
+#define HAVE_C99_inline 1
+#define HAVE___inline 1
+#undef HAVE_BEECRYPT_SHA1
+#define HAVE_BIND_WITH_STRUCT_SOCKADDR 1
+#define HAVE_BSD_STRUCT_RUSAGE 1
+#define HAVE_BUILTIN_SHA1 1
+#define HAVE_CLOCK_GETTIME 1
+#undef HAVE_DBOPEN
+#define HAVE_EPOLL 1
+#undef HAVE_FCHROOT
+#define HAVE_FREEADDRINFO 1
+#undef HAVE_FREEBSD_SHA1
+#define HAVE_GAI_STRERROR 1
+#define HAVE_GETADDRINFO 1
+#define HAVE_GETHOSTBYNAME 1
+#define HAVE_GETOPT_LONG 1
+#define HAVE_GETPAGESIZE 1
+#define HAVE_GETRUSAGE 1
+#define HAVE_HERROR 1
+#define HAVE_HSTRERROR 1
+#undef HAVE_KEVENT_INT_UDATA
+#undef HAVE_KQUEUE
+#undef HAVE_NETBSD_SHA1
+#undef HAVE_OPENSSL_SHA1
+#undef HAVE_SETPROCTITLE
+#define HAVE_SHA1 1
+#undef HAVE_SOCKER_GET
+#undef HAVE_SQLITE3
+#define HAVE_UNAME 1
+#define HAVE_AVX2_INTRINSICS 1
+#define HAVE_AVX512_INTRINSICS 1
+#undef HAVE_BIG_ENDIAN
+#define HAVE_LITTLE_ENDIAN 1
+#define HAVE_SHA_INTRINSICS 1
+#define HAVE_SSSE3_INTRINSICS 1
+#define HAVE_MSG_MORE 1
+#define HAVE_SHUT_RD 1
+#define HAVE_SHUT_RDWR 1
+#define HAVE_SHUT_WR 1
+#undef HAVE_MSGHDR_ACCRIGHTS
+#define HAVE_MSGHDR_CONTROL 1
+#undef HAVE_MSGHDR_FLAGS
+#undef HAVE_SOCKADDR_UN_SUN_LEN
+#undef HAVE_DB_185_H
+#undef HAVE_DB_H
+#undef HAVE_IPV6_SUPPORT
+#undef HAVE_SQLITE3
+#undef HAVE_ZLIB_H
+#undef HAVE_ZLIB_SUPPORT
+
+#endif /* CONFIG_HEADER_FILE */
@@ -56,7 +56,7 @@ base32_encode(char *dst, size_t size, const void *data, size_t len)
     switch (len - i) {
     case 4: k = 7; break;
     case 3: k = 5; break;
-    case 2: k = 3; break;
+    case 2: k = 4; break;
     case 1: k = 2; break;
     default:
       k = 8;
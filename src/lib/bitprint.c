@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "bitprint.h"
+#include "compat.h"
+
+#include <setjmp.h>
+
+/**
+ * Hashes "size" bytes at "data" with each of the hash contexts which is
+ * not NULL, one block of BITPRINT_BLOCK bytes after another.
+ */
+void
+bitprint_update(struct compat_sha1 *sha1, TT_CONTEXT *tt,
+  struct tiger_ctx *tiger, const void *data, size_t size)
+{
+  const char *p = data;
+
+  while (size > 0) {
+    size_t n = MIN(size, BITPRINT_BLOCK);
+
+    if (sha1) {
+      compat_sha1_update(sha1, p, n);
+    }
+    if (tt) {
+      tt_update(tt, p, n);
+    }
+    if (tiger) {
+      tiger_update(tiger, p, n);
+    }
+    p += n;
+    size -= n;
+  }
+}
+
+/*
+ * If the file shrinks while it is mapped, touching the mapping beyond the
+ * new end raises SIGBUS. The hash contexts are saved every
+ * BITPRINT_MMAP_STEP bytes, so the handler can jump back and the step
+ * which faulted is rolled back.
+ */
+#define BITPRINT_MMAP_STEP (1024 * 1024)
+
+static sigjmp_buf bitprint_sigbus_env;
+
+static void
+bitprint_sigbus(int signo)
+{
+  (void) signo;
+  siglongjmp(bitprint_sigbus_env, 1);
+}
+
+/**
+ * Hashes "size" bytes of the regular file "fd" from "offset" on like
+ * bitprint_update(). Only one thread may use this at a time because of
+ * the SIGBUS handler.
+ *
+ * Fewer bytes are hashed if mmap() fails or the file shrinks. Nothing is
+ * hashed if "tt" is hooked: the rollback after SIGBUS cannot take back
+ * the leaves and nodes already passed on to a tree collector or to
+ * callbacks. The file offset of "fd" is set to just after the bytes
+ * hashed in any case, so the caller can read() the rest.
+ *
+ * @return 0 on success, -1 if the file offset could not be set.
+ */
+int
+bitprint_mmap(int fd, uint64_t offset, uint64_t size,
+  struct compat_sha1 *sha1, TT_CONTEXT *tt, struct tiger_ctx *tiger)
+{
+  static struct compat_sha1 sha1_saved;
+  static TT_CONTEXT tt_saved;
+  static struct tiger_ctx tiger_saved;
+  static char *map;
+  static size_t map_len;
+  volatile uint64_t done = 0;
+  size_t page = compat_getpagesize();
+  void (*old_handler)(int);
+
+  if (tt && tt->hooked)
+    goto finish;
+
+  old_handler = set_signal(SIGBUS, bitprint_sigbus);
+  if (SIG_ERR == old_handler)
+    goto finish;
+
+  if (sigsetjmp(bitprint_sigbus_env, 1)) {
+    /* The step after "done" faulted */
+    if (sha1) {
+      *sha1 = sha1_saved;
+    }
+    if (tt) {
+      *tt = tt_saved;
+    }
+    if (tiger) {
+      *tiger = tiger_saved;
+    }
+    munmap(map, map_len);
+    goto restore;
+  }
+
+  while (done < size) {
+    uint64_t pos = offset + done, base = pos - pos % page;
+    size_t i, skip = pos - base;
+
+    map_len = MIN(size - done + skip, BITPRINT_MMAP_WINDOW);
+    map = mmap(NULL, map_len, PROT_READ, MAP_SHARED, fd, base);
+    if (MAP_FAILED == map)
+      break;
+
+#ifdef MADV_SEQUENTIAL
+    madvise(map, map_len, MADV_SEQUENTIAL);
+#endif /* MADV_SEQUENTIAL */
+#ifdef MADV_HUGEPAGE
+    madvise(map, map_len, MADV_HUGEPAGE);
+#endif /* MADV_HUGEPAGE */
+
+    for (i = skip; i < map_len; i += BITPRINT_MMAP_STEP) {
+      size_t n = MIN(map_len - i, BITPRINT_MMAP_STEP);
+
+      if (sha1) {
+        sha1_saved = *sha1;
+      }
+      if (tt) {
+        tt_saved = *tt;
+      }
+      if (tiger) {
+        tiger_saved = *tiger;
+      }
+      bitprint_update(sha1, tt, tiger, &map[i], n);
+      done += n;
+    }
+
+    /* The window is done, drop it so that the RSS stays small */
+    munmap(map, map_len);
+  }
+
+restore:
+  set_signal(SIGBUS, old_handler);
+finish:
+  return (off_t) -1 == lseek(fd, offset + done, SEEK_SET) ? -1 : 0;
+}
+
+struct bitprint_uring_slot {
+  uint64_t pos;                 /* file offset of the block */
+  size_t want;                  /* size of the block */
+  size_t got;                   /* bytes read so far */
+  enum {
+    BITPRINT_SLOT_IDLE,
+    BITPRINT_SLOT_BUSY,
+    BITPRINT_SLOT_READY,
+    BITPRINT_SLOT_FAILED
+  } state;
+};
+
+/**
+ * Hashes "size" bytes of the regular file "fd" from "offset" on like
+ * bitprint_update(), reading it with "ur". Every slot of the ring holds
+ * one block of URING_BLOCK bytes, and the following blocks are being
+ * read while the current one is hashed.
+ *
+ * The last block is read up to the next page boundary which keeps the reads
+ * aligned for O_DIRECT if "offset" is.
+ *
+ * If a read fails or ends early, the blocks from there on are not hashed.
+ * In any case the file offset is set behind the hashed data, so the caller
+ * can go on with read() from there.
+ *
+ * @return 0 on success, -1 if the file offset could not be set.
+ */
+int
+bitprint_uring(struct uring *ur, int fd, uint64_t offset, uint64_t size,
+  struct compat_sha1 *sha1, TT_CONTEXT *tt, struct tiger_ctx *tiger)
+{
+  struct bitprint_uring_slot slots[URING_DEPTH_MAX];
+  unsigned i, depth = uring_depth(ur), busy = 0;
+  size_t page = compat_getpagesize();
+  uint64_t queued = 0, hashed = 0, done = 0;  /* blocks, blocks, bytes */
+  uint64_t blocks = size / URING_BLOCK + (size % URING_BLOCK ? 1 : 0);
+  bool stop = false;
+
+  for (i = 0; i < depth; i++) {
+    slots[i].state = BITPRINT_SLOT_IDLE;
+  }
+
+  for (;;) {
+    struct bitprint_uring_slot *s;
+    uint64_t tag;
+    int res;
+
+    /* Hash the completed blocks in order */
+    while (hashed < queued) {
+      s = &slots[hashed % depth];
+      if (BITPRINT_SLOT_READY != s->state) {
+        stop |= BITPRINT_SLOT_FAILED == s->state;
+        break;
+      }
+      bitprint_update(sha1, tt, tiger, uring_slot(ur, hashed % depth),
+          s->got);
+      s->state = BITPRINT_SLOT_IDLE;
+      done += s->got;
+      hashed++;
+      if (s->got != s->want) {
+        /* Nothing after a short block may be hashed */
+        stop = true;
+        hashed = queued;
+        break;
+      }
+    }
+
+    /* Keep every idle slot busy with one of the next blocks */
+    while (!stop && queued < blocks) {
+      i = queued % depth;
+      s = &slots[i];
+      if (BITPRINT_SLOT_IDLE != s->state)
+        break;
+
+      s->pos = offset + queued * URING_BLOCK;
+      s->want = MIN(size - queued * URING_BLOCK, URING_BLOCK);
+      s->got = 0;
+      if (
+        uring_read(ur, fd, uring_slot(ur, i), round_size(page, s->want),
+          s->pos, i)
+      ) {
+        stop = true;
+        break;
+      }
+      s->state = BITPRINT_SLOT_BUSY;
+      queued++;
+      busy++;
+    }
+
+    if (0 == busy)
+      break;
+
+    if (uring_wait(ur, &tag, &res))
+      break;
+
+    s = &slots[tag];
+    if (res > 0) {
+      s->got = MIN(s->got + res, s->want);
+    }
+    if ((res > 0 && s->got < s->want) || -EINTR == res || -EAGAIN == res) {
+      /* Ask for the rest */
+      if (
+        0 == uring_read(ur, fd, uring_slot(ur, tag) + s->got,
+          s->want - s->got, s->pos + s->got, tag)
+      ) {
+        continue;
+      }
+      res = -1;
+    }
+    /* A read of zero bytes means the file was truncated meanwhile */
+    s->state = res >= 0 ? BITPRINT_SLOT_READY : BITPRINT_SLOT_FAILED;
+    busy--;
+  }
+
+  return (off_t) -1 == lseek(fd, offset + done, SEEK_SET) ? -1 : 0;
+}
+
+#ifdef HAVE_PTHREAD_SUPPORT
+
+#define BITPRINT_PIPE_SLOTS     8
+#define BITPRINT_PIPE_BUFSIZE   (128 * 1024)
+
+struct bitprint_slot {
+  char *data;
+  size_t len;
+  unsigned refs;                /* threads yet to hash it; under lock */
+};
+
+struct bitprint_consumer {
+  struct bitprint_pipe *bp;
+  pthread_t thread;
+  void (*update)(void *ctx, const void *data, size_t size);
+  void *ctx;
+  uint64_t seq;                 /* next buffer to hash; under lock */
+};
+
+struct bitprint_pipe {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;          /* signaled on every state change */
+  struct bitprint_slot slots[BITPRINT_PIPE_SLOTS];
+  struct bitprint_consumer consumers[3];
+  unsigned num_consumers;
+  uint64_t filled;              /* number of buffers submitted */
+  bool eof;                     /* no more buffers will be submitted */
+  size_t fill;                  /* bytes in the current buffer */
+};
+
+static void
+bitprint_sha1_update(void *ctx, const void *data, size_t size)
+{
+  compat_sha1_update(ctx, data, size);
+}
+
+static void
+bitprint_tt_update(void *ctx, const void *data, size_t size)
+{
+  tt_update(ctx, data, size);
+}
+
+static void
+bitprint_tiger_update(void *ctx, const void *data, size_t size)
+{
+  tiger_update(ctx, data, size);
+}
+
+static void *
+bitprint_pipe_worker(void *arg)
+{
+  struct bitprint_consumer *c = arg;
+  struct bitprint_pipe *bp = c->bp;
+
+  pthread_mutex_lock(&bp->lock);
+  for (;;) {
+    struct bitprint_slot *slot;
+
+    if (c->seq == bp->filled) {
+      if (bp->eof)
+        break;
+      pthread_cond_wait(&bp->cond, &bp->lock);
+      continue;
+    }
+
+    slot = &bp->slots[c->seq % BITPRINT_PIPE_SLOTS];
+    pthread_mutex_unlock(&bp->lock);
+
+    c->update(c->ctx, slot->data, slot->len);
+
+    pthread_mutex_lock(&bp->lock);
+    c->seq++;
+    RUNTIME_ASSERT(slot->refs > 0);
+    if (0 == --slot->refs) {
+      pthread_cond_broadcast(&bp->cond);
+    }
+  }
+  pthread_mutex_unlock(&bp->lock);
+  return NULL;
+}
+
+static void
+bitprint_pipe_submit(struct bitprint_pipe *bp)
+{
+  struct bitprint_slot *slot = &bp->slots[bp->filled % BITPRINT_PIPE_SLOTS];
+
+  pthread_mutex_lock(&bp->lock);
+  slot->len = bp->fill;
+  slot->refs = bp->num_consumers;
+  bp->filled++;
+  bp->fill = 0;
+  pthread_cond_broadcast(&bp->cond);
+  pthread_mutex_unlock(&bp->lock);
+}
+
+/* tells the threads to stop once they are done and waits for them */
+static void
+bitprint_pipe_join(struct bitprint_pipe *bp)
+{
+  unsigned i;
+
+  pthread_mutex_lock(&bp->lock);
+  bp->eof = true;
+  pthread_cond_broadcast(&bp->cond);
+  pthread_mutex_unlock(&bp->lock);
+
+  for (i = 0; i < bp->num_consumers; i++) {
+    pthread_join(bp->consumers[i].thread, NULL);
+  }
+  pthread_cond_destroy(&bp->cond);
+  pthread_mutex_destroy(&bp->lock);
+}
+
+static void
+bitprint_pipe_free(struct bitprint_pipe *bp)
+{
+  unsigned i;
+
+  for (i = 0; i < BITPRINT_PIPE_SLOTS; i++) {
+    if (bp->slots[i].data) {
+      compat_page_free(bp->slots[i].data, BITPRINT_PIPE_BUFSIZE);
+    }
+  }
+  free(bp);
+}
+
+/**
+ * Starts a thread for each of the contexts which is not NULL. The
+ * contexts must be initialized and are updated by the threads until
+ * bitprint_pipe_finish() returns.
+ *
+ * @return NULL on failure.
+ */
+struct bitprint_pipe *
+bitprint_pipe_new(struct compat_sha1 *sha1, TT_CONTEXT *tt,
+  struct tiger_ctx *tiger)
+{
+  struct bitprint_pipe *bp;
+  unsigned i, n = 0;
+
+  bp = calloc(1, sizeof *bp);
+  if (!bp)
+    return NULL;
+
+  for (i = 0; i < BITPRINT_PIPE_SLOTS; i++) {
+    /* Page-aligned for O_DIRECT */
+    bp->slots[i].data = compat_page_align(BITPRINT_PIPE_BUFSIZE);
+    if (!bp->slots[i].data) {
+      bitprint_pipe_free(bp);
+      return NULL;
+    }
+  }
+
+  if (sha1) {
+    bp->consumers[n].update = bitprint_sha1_update;
+    bp->consumers[n++].ctx = sha1;
+  }
+  if (tt) {
+    bp->consumers[n].update = bitprint_tt_update;
+    bp->consumers[n++].ctx = tt;
+  }
+  if (tiger) {
+    bp->consumers[n].update = bitprint_tiger_update;
+    bp->consumers[n++].ctx = tiger;
+  }
+  RUNTIME_ASSERT(n > 0);
+
+  pthread_mutex_init(&bp->lock, NULL);
+  pthread_cond_init(&bp->cond, NULL);
+  for (i = 0; i < n; i++) {
+    struct bitprint_consumer *c = &bp->consumers[i];
+
+    c->bp = bp;
+    if (pthread_create(&c->thread, NULL, bitprint_pipe_worker, c))
+      break;
+    bp->num_consumers++;
+  }
+
+  /* Every context needs its thread, nothing has been hashed yet */
+  if (bp->num_consumers < n) {
+    bitprint_pipe_join(bp);
+    bitprint_pipe_free(bp);
+    return NULL;
+  }
+  return bp;
+}
+
+/**
+ * Waits until the next buffer is free if necessary.
+ *
+ * @return the free space of the current buffer and its size in "size".
+ */
+char *
+bitprint_pipe_space(struct bitprint_pipe *bp, size_t *size)
+{
+  struct bitprint_slot *slot = &bp->slots[bp->filled % BITPRINT_PIPE_SLOTS];
+
+  if (0 == bp->fill) {
+    pthread_mutex_lock(&bp->lock);
+    while (slot->refs > 0) {
+      pthread_cond_wait(&bp->cond, &bp->lock);
+    }
+    pthread_mutex_unlock(&bp->lock);
+  }
+
+  *size = BITPRINT_PIPE_BUFSIZE - bp->fill;
+  return &slot->data[bp->fill];
+}
+
+/**
+ * Appends "n" bytes which were stored at bitprint_pipe_space() to the
+ * input.
+ */
+void
+bitprint_pipe_commit(struct bitprint_pipe *bp, size_t n)
+{
+  RUNTIME_ASSERT(n <= BITPRINT_PIPE_BUFSIZE - bp->fill);
+
+  bp->fill += n;
+  if (BITPRINT_PIPE_BUFSIZE == bp->fill) {
+    bitprint_pipe_submit(bp);
+  }
+}
+
+/**
+ * Hashes the rest of the input and waits for the threads. The contexts
+ * can be finalized afterwards. "bp" is freed.
+ */
+void
+bitprint_pipe_finish(struct bitprint_pipe *bp)
+{
+  if (bp->fill > 0) {
+    bitprint_pipe_submit(bp);
+  }
+  bitprint_pipe_join(bp);
+  bitprint_pipe_free(bp);
+}
+
+#else /* !HAVE_PTHREAD_SUPPORT */
+
+struct bitprint_pipe *
+bitprint_pipe_new(struct compat_sha1 *sha1, TT_CONTEXT *tt,
+  struct tiger_ctx *tiger)
+{
+  (void) sha1;
+  (void) tt;
+  (void) tiger;
+  errno = ENOSYS;
+  return NULL;
+}
+
+char *
+bitprint_pipe_space(struct bitprint_pipe *bp, size_t *size)
+{
+  (void) bp;
+  *size = 0;
+  return NULL;
+}
+
+void
+bitprint_pipe_commit(struct bitprint_pipe *bp, size_t n)
+{
+  (void) bp;
+  (void) n;
+}
+
+void
+bitprint_pipe_finish(struct bitprint_pipe *bp)
+{
+  (void) bp;
+}
+
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef BITPRINT_HEADER_FILE
+#define BITPRINT_HEADER_FILE
+
+#include "common.h"
+#include "compat_sha1.h"
+#include "tigertree.h"
+#include "tiger.h"
+#include "uring.h"
+
+/*
+ * bitprint_update() feeds the same data to SHA-1, the TTH and Tiger, but
+ * BITPRINT_BLOCK bytes at a time so that each block is still in the L1
+ * cache when the next hash reads it. The block is small enough to leave
+ * room for the Tiger S-boxes (8 KiB) and a multiple of the leaves which
+ * the TTH hashes at once.
+ */
+#define BITPRINT_BLOCK (8 * 1024)
+
+void bitprint_update(struct compat_sha1 *sha1, TT_CONTEXT *tt,
+    struct tiger_ctx *tiger, const void *data, size_t size);
+
+/*
+ * bitprint_mmap() hashes a regular file from windows of up to
+ * BITPRINT_MMAP_WINDOW bytes mapped into memory, which saves the copy of
+ * read(). Smaller files are not worth the setup.
+ */
+#define BITPRINT_MMAP_WINDOW  (16 * 1024 * 1024)
+#define BITPRINT_MMAP_MIN     (256 * 1024)
+
+int bitprint_mmap(int fd, uint64_t offset, uint64_t size,
+    struct compat_sha1 *sha1, TT_CONTEXT *tt, struct tiger_ctx *tiger);
+
+/*
+ * bitprint_uring() hashes a regular file like bitprint_mmap() but reads it
+ * into the slots of the given ring, keeping as many reads in flight as the
+ * ring has slots.
+ */
+int bitprint_uring(struct uring *ur, int fd, uint64_t offset, uint64_t size,
+    struct compat_sha1 *sha1, TT_CONTEXT *tt, struct tiger_ctx *tiger);
+
+/*
+ * A bitprint pipe hashes each of the given contexts on a thread of its
+ * own. The caller reads the input into the buffers returned by
+ * bitprint_pipe_space(), and each buffer is reused once every thread
+ * is done with it.
+ */
+struct bitprint_pipe;
+
+struct bitprint_pipe *bitprint_pipe_new(struct compat_sha1 *sha1,
+    TT_CONTEXT *tt, struct tiger_ctx *tiger);
+char *bitprint_pipe_space(struct bitprint_pipe *bp, size_t *size);
+void bitprint_pipe_commit(struct bitprint_pipe *bp, size_t n);
+void bitprint_pipe_finish(struct bitprint_pipe *bp);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* BITPRINT_HEADER_FILE */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "check.h"
+#include "base32.h"
+
+/**
+ * Decodes the base32 string of "len" characters at "s" into "size" bytes.
+ *
+ * @return true if "s" is a valid encoding of exactly that many bytes.
+ */
+static bool
+urn_decode(void *dst, size_t size, const char *s, size_t len)
+{
+  char buf[64];
+  size_t n;
+
+  if (len != (size * 8 + 4) / 5 || len > sizeof buf - 8)
+    return false;
+
+  /* base32_decode() only decodes complete groups of 8 characters */
+  n = (len + 7) & ~(size_t) 7;
+  memcpy(buf, s, len);
+  memset(&buf[len], '=', n - len);
+  return size == base32_decode(dst, size, buf, n);
+}
+
+/**
+ * Parses the result line "line" of "len" bytes and decodes the digests of
+ * its URN. Trailing white space is removed and the line is cut after the
+ * name of the file, so "line" is the name afterwards.
+ *
+ * @return the digests found, see enum digest, or 0 if the line is
+ * improperly formatted.
+ */
+unsigned
+check_parse(char *line, size_t len, struct sha1 *sha1, struct tth *tth,
+    struct tiger_hash *tiger)
+{
+  static const char sep[] = ": urn:";
+  char *urn = NULL, *dot, *q;
+  const char *s;
+
+  while (len > 0 && isspace((unsigned char) line[len - 1])) {
+    line[--len] = '\0';
+  }
+
+  /* The name may contain the separator, the URN does not */
+  for (q = line; NULL != (q = strstr(q, sep)); q++) {
+    urn = q;
+  }
+  if (!urn || urn == line)
+    return 0;
+
+  *urn = '\0';
+  urn += 2;
+
+  if (NULL != (s = skip_ci_prefix(urn, "urn:bitprint:"))) {
+    dot = strchr(s, '.');
+    if (
+      dot &&
+      urn_decode(sha1->data, sizeof sha1->data, s, dot - s) &&
+      urn_decode(tth->data, sizeof tth->data, &dot[1], strlen(&dot[1]))
+    ) {
+      return DIGEST_SHA1 | DIGEST_TTH;
+    }
+  } else if (NULL != (s = skip_ci_prefix(urn, "urn:sha1:"))) {
+    if (urn_decode(sha1->data, sizeof sha1->data, s, strlen(s))) {
+      return DIGEST_SHA1;
+    }
+  } else if (NULL != (s = skip_ci_prefix(urn, "urn:tree:tiger:"))) {
+    if (urn_decode(tth->data, sizeof tth->data, s, strlen(s))) {
+      return DIGEST_TTH;
+    }
+  } else if (NULL != (s = skip_ci_prefix(urn, "urn:tiger:"))) {
+    if (urn_decode(tiger->data, sizeof tiger->data, s, strlen(s))) {
+      return DIGEST_TIGER;
+    }
+  }
+  return 0;
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
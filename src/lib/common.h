@@ -367,6 +367,12 @@ typedef uint64_t uintptr_t;
 #define NO_RETURN
 #endif /* HAVE_GCC(3,0) */
 
+#if HAVE_GCC(3,1)
+#define ALWAYS_INLINE __attribute__((__always_inline__))
+#else
+#define ALWAYS_INLINE
+#endif /* HAVE_GCC(3,1) */
+
 #ifndef HAVE_C99_func
 /* __FUNCTION__ is something else!
  * __func__ must not be used like printf("blah" __func__ "blubb")! */
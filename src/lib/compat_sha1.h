@@ -31,7 +31,8 @@
 #include "common.h"
 #include "nettools.h"
 
-#if !defined(HAVE_OPENSSL_SHA1) && \
+#if !defined(HAVE_BUILTIN_SHA1) && \
+    !defined(HAVE_OPENSSL_SHA1) && \
     !defined(HAVE_FREEBSD_SHA1) && \
     !defined(HAVE_NETBSD_SHA1) && \
     !defined(HAVE_BEECRYPT_SHA1)
@@ -41,13 +42,46 @@
 
 #ifdef HAVE_SHA1
 
+#ifdef HAVE_BUILTIN_SHA1
+#include "sha1.h"
+struct compat_sha1 { struct sha1_ctx data; };
+
+static inline void
+compat_sha1_init(struct compat_sha1 *ctx)
+{
+  sha1_init(&ctx->data);
+}
+
+static inline void
+compat_sha1_update(struct compat_sha1 *ctx, const void *data, size_t size)
+{
+  sha1_update(&ctx->data, data, size);
+}
+
+static inline void
+compat_sha1_final(struct compat_sha1 *ctx, struct sha1 *md)
+{
+  sha1_final(&ctx->data, md->data);
+}
+
+static inline void
+compat_sha1_multi(const void * const data[], const size_t size[], size_t n,
+    struct sha1 md[])
+{
+  STATIC_ASSERT(20 == sizeof md[0]);
+  sha1_multi(data, size, n, (void *) md);
+}
+#endif /* HAVE_BUILTIN_SHA1 */
+
 /* OpenSSL and FreeBSD use the same prototypes but different header files. */
 #if defined(HAVE_OPENSSL_SHA1) || defined(HAVE_FREEBSD_SHA1)
 
 #if defined(HAVE_OPENSSL_SHA1)
 #include <openssl/sha.h>
+#define COMPAT_SHA1_NAME "openssl"
 #else
 #include <sha.h>
+#define COMPAT_SHA1_NAME "libmd"
 #endif /* HAVE_OPENSSL_SHA1 */
 
 struct compat_sha1 { SHA_CTX data; };
@@ -72,6 +106,7 @@ compat_sha1_final(struct compat_sha1 *ctx, struct sha1 *md)
 
 #ifdef HAVE_NETBSD_SHA1
 #include <sha1.h>
+#define COMPAT_SHA1_NAME "libc"
 struct compat_sha1 { SHA1_CTX data; };
 
 static inline void
@@ -104,6 +139,7 @@ compat_sha1_final(struct compat_sha1 *ctx, struct sha1 *md)
 
 #ifdef HAVE_BEECRYPT_SHA1
 #include <beecrypt/sha1.h>
+#define COMPAT_SHA1_NAME "beecrypt"
 struct compat_sha1 { sha1Param data; };
 
 static inline void
@@ -131,6 +167,24 @@ static inline void compat_sha1_update(struct compat_sha1 *ctx,
 static inline void compat_sha1_final(struct compat_sha1 *ctx,
     struct sha1 *md);
 
+#ifndef HAVE_BUILTIN_SHA1
+/* The libraries hash one message after another */
+static inline void
+compat_sha1_multi(const void * const data[], const size_t size[], size_t n,
+    struct sha1 md[])
+{
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    struct compat_sha1 ctx;
+
+    compat_sha1_init(&ctx);
+    compat_sha1_update(&ctx, data[i], size[i]);
+    compat_sha1_final(&ctx, &md[i]);
+  }
+}
+#endif /* !HAVE_BUILTIN_SHA1 */
+
 #endif /* HAVE_SHA1 */
 
 /* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "cpu.h"
+
+#ifdef HAVE_SCHED_GETAFFINITY
+#include <sched.h>
+#endif /* HAVE_SCHED_GETAFFINITY */
+
+#ifdef HAVE_CPUID_H
+#include <cpuid.h>
+
+/* XCR0 bits: SSE and AVX state */
+#define XCR0_YMM  0x06
+/* XCR0 bits: opmask, upper ZMM and high ZMM state */
+#define XCR0_ZMM  0xe0
+
+static uint32_t
+cpu_xgetbv(void)
+{
+  uint32_t eax, edx;
+
+  __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  return eax;
+}
+
+static unsigned
+cpu_detect(void)
+{
+  unsigned eax, ebx, ecx, edx, max_leaf, features = 0;
+  uint32_t xcr0 = 0;
+
+  max_leaf = __get_cpuid_max(0, NULL);
+  if (max_leaf < 1 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+
+  if (ecx & bit_SSSE3)
+    features |= CPU_SSSE3;
+  if (ecx & bit_SSE4_1)
+    features |= CPU_SSE41;
+  if (ecx & bit_OSXSAVE)
+    xcr0 = cpu_xgetbv();
+  if ((ecx & bit_AVX) && XCR0_YMM == (xcr0 & XCR0_YMM))
+    features |= CPU_AVX;
+
+  if (max_leaf >= 7) {
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    if (ebx & bit_BMI2)
+      features |= CPU_BMI2;
+    if (ebx & bit_SHA)
+      features |= CPU_SHA;
+    if ((features & CPU_AVX) && (ebx & bit_AVX2))
+      features |= CPU_AVX2;
+    if (
+      (features & CPU_AVX) &&
+      (ebx & bit_AVX512F) &&
+      XCR0_ZMM == (xcr0 & XCR0_ZMM)
+    ) {
+      features |= CPU_AVX512F;
+    }
+  }
+
+  return features;
+}
+#else /* !HAVE_CPUID_H */
+static unsigned
+cpu_detect(void)
+{
+  return 0;
+}
+#endif /* HAVE_CPUID_H */
+
+/**
+ * @return the set of supported CPU features, see enum cpu_feature.
+ */
+unsigned
+cpu_features(void)
+{
+  static bool initialized;
+  static unsigned features;
+
+  if (!initialized) {
+    features = cpu_detect();
+    initialized = true;
+  }
+  return features;
+}
+
+/**
+ * @return true if all of the given CPU features are supported.
+ */
+bool
+cpu_supports(unsigned features)
+{
+  return features == (cpu_features() & features);
+}
+
+/**
+ * Reads the CPU bandwidth limit of a cgroup, "quota period" as found in
+ * cpu.max of cgroup v2 or the two values of cfs_quota_us and cfs_period_us
+ * of cgroup v1.
+ *
+ * @return the number of CPUs the quota amounts to, rounded up, or 0 if
+ * there is no limit.
+ */
+static unsigned
+cpu_quota(const char *quota_path, const char *period_path)
+{
+  long long quota = -1, period = 0;
+  char buf[64];
+  FILE *f;
+
+  f = fopen(quota_path, "r");
+  if (!f)
+    return 0;
+
+  if (fgets(buf, sizeof buf, f)) {
+    if (period_path) {
+      quota = strtoll(buf, NULL, 10);
+    } else if (2 != sscanf(buf, "%lld %lld", &quota, &period)) {
+      quota = -1;       /* "max" */
+    }
+  }
+  fclose(f);
+
+  if (period_path) {
+    f = fopen(period_path, "r");
+    if (f) {
+      if (fgets(buf, sizeof buf, f)) {
+        period = strtoll(buf, NULL, 10);
+      }
+      fclose(f);
+    }
+  }
+
+  if (quota <= 0 || period <= 0)
+    return 0;
+  return MAX(1, (quota + period - 1) / period);
+}
+
+/**
+ * Looks up the cgroup v2 of this process in /proc/self/cgroup and reads
+ * its cpu.max. Limits of parent groups are not taken into account.
+ */
+static unsigned
+cpu_cgroup2_quota(void)
+{
+  char line[1024], path[sizeof line + 64];
+  unsigned n = 0;
+  FILE *f;
+
+  f = fopen("/proc/self/cgroup", "r");
+  if (!f)
+    return 0;
+
+  while (fgets(line, sizeof line, f)) {
+    char *nl = strchr(line, '\n');
+
+    if (nl) {
+      *nl = '\0';
+    }
+    if (0 == strncmp(line, "0::", 3)) {
+      snprintf(path, sizeof path, "/sys/fs/cgroup%s/cpu.max", &line[3]);
+      n = cpu_quota(path, NULL);
+      break;
+    }
+  }
+  fclose(f);
+  return n;
+}
+
+/**
+ * @return the number of CPUs this process may use, taking the CPU
+ * affinity mask and cgroup CPU quotas into account; at least 1.
+ */
+unsigned
+cpu_count(void)
+{
+  unsigned quota, n = 0;
+
+#ifdef HAVE_SCHED_GETAFFINITY
+  {
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    if (0 == sched_getaffinity(0, sizeof set, &set)) {
+      n = CPU_COUNT(&set);
+    }
+  }
+#endif /* HAVE_SCHED_GETAFFINITY */
+
+#if defined(_SC_NPROCESSORS_ONLN)
+  if (0 == n) {
+    long ret = sysconf(_SC_NPROCESSORS_ONLN);
+
+    n = ret > 0 ? ret : 0;
+  }
+#endif /* _SC_NPROCESSORS_ONLN */
+
+  n = MAX(1, n);
+
+  quota = cpu_cgroup2_quota();
+  if (0 == quota) {
+    quota = cpu_quota("/sys/fs/cgroup/cpu/cpu.cfs_quota_us",
+        "/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+  }
+  if (quota > 0) {
+    n = MIN(n, quota);
+  }
+  return n;
+}
+
+void
+cpu_print_features(FILE *f)
+{
+  static const struct {
+    const char *name;
+    unsigned feature;
+  } names[] = {
+    { "ssse3",    CPU_SSSE3 },
+    { "sse4.1",   CPU_SSE41 },
+    { "avx",      CPU_AVX },
+    { "avx2",     CPU_AVX2 },
+    { "bmi2",     CPU_BMI2 },
+    { "avx512f",  CPU_AVX512F },
+    { "sha",      CPU_SHA },
+  };
+  unsigned i, n = 0;
+
+  for (i = 0; i < ARRAY_LEN(names); i++) {
+    if (cpu_supports(names[i].feature)) {
+      fputs(n++ ? " " : "", f);
+      fputs(names[i].name, f);
+    }
+  }
+  fputs(n ? "\n" : "none\n", f);
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef CPU_HEADER_FILE
+#define CPU_HEADER_FILE
+
+#include "common.h"
+
+/*
+ * Instruction set extensions which are relevant for the hash kernels.
+ * A feature is only reported if the operating system saves the
+ * respective register state as well.
+ */
+enum cpu_feature {
+  CPU_SSSE3   = 1 << 0,
+  CPU_SSE41   = 1 << 1,
+  CPU_AVX     = 1 << 2,
+  CPU_AVX2    = 1 << 3,
+  CPU_BMI2    = 1 << 4,
+  CPU_AVX512F = 1 << 5,
+  CPU_SHA     = 1 << 6
+};
+
+unsigned cpu_features(void);
+bool cpu_supports(unsigned features);
+void cpu_print_features(FILE *f);
+unsigned cpu_count(void);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* CPU_HEADER_FILE */
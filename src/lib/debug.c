@@ -94,6 +94,20 @@ fatality(const char *fmt, ...)
   exit(EXIT_FAILURE);
 }
 
+/**
+ * Reports a failed system call, with the filename unless it is NULL.
+ */
+void
+print_error(const char *func, const char *filename, int error)
+{
+  if (filename) {
+    fprintf(stderr, "%s(\"%s\"): %s\n", func, filename,
+      compat_strerror(error));
+  } else {
+    fprintf(stderr, "%s(): %s\n", func, compat_strerror(error));
+  }
+}
+
 void
 note_prefix(const char *file, int line, note_level_t level)
 {
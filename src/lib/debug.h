@@ -51,6 +51,7 @@ void printerr_info(const char *fmt, ...) CHECK_FMT(1, 2);
 void printerr_verb(const char *fmt, ...) CHECK_FMT(1, 2);
 void printerr_dbug(const char *fmt, ...) CHECK_FMT(1, 2);
 void note_prefix(const char *file, int line, note_level_t level);
+void print_error(const char *func, const char *filename, int error);
 
 #if defined(HAVE_C99_VARIADIC_MACROS)
 #define FATAL(...) note(__FILE__, __LINE__, NOTE_FATAL, ## __VA_ARGS__)
@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "hashcache.h"
+
+#include <stddef.h>
+
+#ifdef HAVE_FGETXATTR
+#include <sys/xattr.h>
+#endif /* HAVE_FGETXATTR */
+
+#define HASHCACHE_MAGIC     "BitterHC"
+#define HASHCACHE_VERSION   1
+#define HASHCACHE_ORDER     ((uint64_t) 0x0102030405060708ULL)
+#define HASHCACHE_SLOTS_MIN 4096        /* a power of two */
+
+#define HASHCACHE_XATTR     "user.bitprint"
+#define HASHCACHE_XATTR_LEN (2 + 8 + 8 + 20 + 24)
+
+/*
+ * The database starts with a header which is followed by a hash table with
+ * open addressing, which is grown to keep it at most three quarters full.
+ * Numbers are stored as on the host; a database written by a host of
+ * another kind is started afresh. Each slot carries a checksum, so that a
+ * slot which was only partly written when the system went down is never
+ * taken for valid.
+ */
+struct hashcache_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t slot_size;
+  uint64_t order;               /* HASHCACHE_ORDER */
+  uint64_t capacity;            /* number of slots */
+  uint64_t count;               /* slots in use */
+  uint64_t reserved[3];
+};
+
+struct hashcache_slot {
+  uint64_t dev, ino, size;
+  int64_t mtime, ctime;
+  unsigned char sha1[20];
+  char tth[24];
+  uint32_t digests;             /* 0 if the slot is empty */
+  uint32_t check;               /* of all of the above */
+  uint32_t reserved;
+};
+
+struct hashcache {
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_t lock;
+#endif /* HAVE_PTHREAD_SUPPORT */
+  int fd;                       /* the database or -1 for attributes */
+  int64_t racy;                 /* files changed since are not stored */
+  struct hashcache_header *header;
+  struct hashcache_slot *slots;
+  size_t map_size;
+};
+
+static inline void
+hashcache_lock(struct hashcache *hc)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_lock(&hc->lock);
+#else
+  (void) hc;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+static inline void
+hashcache_unlock(struct hashcache *hc)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_unlock(&hc->lock);
+#else
+  (void) hc;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+/**
+ * Allocates a cache which does not store anything yet.
+ */
+static struct hashcache *
+hashcache_new(void)
+{
+  struct hashcache *hc;
+  struct timeval tv;
+
+  hc = calloc(1, sizeof *hc);
+  if (!hc)
+    return NULL;
+
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_init(&hc->lock, NULL);
+#endif /* HAVE_PTHREAD_SUPPORT */
+  hc->fd = -1;
+  gettimeofday(&tv, NULL);
+  hc->racy = ((int64_t) tv.tv_sec * 1000000 + tv.tv_usec) * 1000 -
+    HASHCACHE_RACY_NS;
+  return hc;
+}
+
+/**
+ * Fills in "key" from the status of a file.
+ */
+void
+hashcache_key(struct hashcache_key *key, const struct stat *sb)
+{
+  int64_t mtime_ns, ctime_ns;
+
+#ifdef HAVE_ST_MTIM
+  mtime_ns = sb->st_mtim.tv_nsec;
+  ctime_ns = sb->st_ctim.tv_nsec;
+#else
+  mtime_ns = 0;
+  ctime_ns = 0;
+#endif /* HAVE_ST_MTIM */
+
+  key->dev = sb->st_dev;
+  key->ino = sb->st_ino;
+  key->size = sb->st_size;
+  key->mtime = (int64_t) sb->st_mtime * 1000000000 + mtime_ns;
+  key->ctime = (int64_t) sb->st_ctime * 1000000000 + ctime_ns;
+}
+
+/*
+ * The database
+ */
+
+static uint32_t
+hashcache_check(const struct hashcache_slot *slot)
+{
+  const unsigned char *p = (const void *) slot;
+  uint32_t h = 2166136261U;     /* FNV-1a */
+  size_t i;
+
+  for (i = 0; i < offsetof(struct hashcache_slot, check); i++) {
+    h = (h ^ p[i]) * 16777619U;
+  }
+  return h;
+}
+
+static inline size_t
+hashcache_index(const struct hashcache *hc, uint64_t dev, uint64_t ino)
+{
+  uint64_t h = ino ^ (dev * (uint64_t) 0x9E3779B97F4A7C15ULL);
+
+  h ^= h >> 33;
+  h *= (uint64_t) 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  return h & (hc->header->capacity - 1);
+}
+
+/**
+ * @return the slot of "dev" and "ino" or the empty slot to put it in.
+ */
+static struct hashcache_slot *
+hashcache_find(struct hashcache *hc, uint64_t dev, uint64_t ino)
+{
+  size_t mask = hc->header->capacity - 1;
+  size_t i = hashcache_index(hc, dev, ino);
+
+  for (;;) {
+    struct hashcache_slot *slot = &hc->slots[i];
+
+    if (0 == slot->digests || (slot->dev == dev && slot->ino == ino))
+      return slot;
+    i = (i + 1) & mask;
+  }
+}
+
+/**
+ * Maps "capacity" slots of the database, after resizing the file to fit.
+ *
+ * @return 0 on success, -1 on failure with errno set.
+ */
+static int
+hashcache_map(struct hashcache *hc, uint64_t capacity)
+{
+  size_t size = sizeof *hc->header + capacity * sizeof *hc->slots;
+  void *map;
+
+  if (hc->header) {
+    munmap(hc->header, hc->map_size);
+    hc->header = NULL;
+    hc->slots = NULL;
+  }
+
+#ifdef HAVE_POSIX_FALLOCATE
+  /* Allocate the blocks now, a full disk would raise SIGBUS later */
+  errno = posix_fallocate(hc->fd, 0, size);
+  if (errno)
+    return -1;
+#else
+  if (ftruncate(hc->fd, size))
+    return -1;
+#endif /* HAVE_POSIX_FALLOCATE */
+
+  map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, hc->fd, 0);
+  if (MAP_FAILED == map)
+    return -1;
+
+  hc->header = map;
+  hc->slots = (void *) &hc->header[1];
+  hc->map_size = size;
+  return 0;
+}
+
+/**
+ * Doubles the number of slots and puts the valid slots in their new place.
+ * The database is left unusable if that fails.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+static int
+hashcache_grow(struct hashcache *hc)
+{
+  uint64_t i, n = 0, capacity = hc->header->capacity;
+  struct hashcache_slot *saved;
+
+  saved = malloc(hc->header->count * sizeof *saved);
+  if (!saved)
+    return -1;
+
+  for (i = 0; i < capacity; i++) {
+    const struct hashcache_slot *slot = &hc->slots[i];
+
+    if (
+      0 != slot->digests &&
+      slot->check == hashcache_check(slot) &&
+      n < hc->header->count
+    ) {
+      saved[n++] = *slot;
+    }
+  }
+
+  if (hashcache_map(hc, 2 * capacity)) {
+    free(saved);
+    return -1;
+  }
+  memset(hc->slots, 0, 2 * capacity * sizeof *hc->slots);
+  hc->header->capacity = 2 * capacity;
+  hc->header->count = n;
+
+  for (i = 0; i < n; i++) {
+    *hashcache_find(hc, saved[i].dev, saved[i].ino) = saved[i];
+  }
+  free(saved);
+  return 0;
+}
+
+/**
+ * Writes an empty database.
+ */
+static int
+hashcache_init(struct hashcache *hc)
+{
+  if (ftruncate(hc->fd, 0) || hashcache_map(hc, HASHCACHE_SLOTS_MIN))
+    return -1;
+
+  memcpy(hc->header->magic, HASHCACHE_MAGIC, sizeof hc->header->magic);
+  hc->header->version = HASHCACHE_VERSION;
+  hc->header->slot_size = sizeof *hc->slots;
+  hc->header->order = HASHCACHE_ORDER;
+  hc->header->capacity = HASHCACHE_SLOTS_MIN;
+  hc->header->count = 0;
+  return 0;
+}
+
+/**
+ * Opens the database "path", which is created if it does not exist. It
+ * is locked as long as it is open.
+ *
+ * @return NULL on failure with errno set: EBUSY if another process is
+ * using the database and EINVAL if the file is something else.
+ */
+struct hashcache *
+hashcache_open(const char *path)
+{
+  struct hashcache *hc;
+  struct hashcache_header header;
+  struct flock lock;
+  struct stat sb;
+  int error;
+
+  hc = hashcache_new();
+  if (!hc)
+    return NULL;
+
+  hc->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (hc->fd < 0)
+    goto failure;
+  fcntl(hc->fd, F_SETFD, FD_CLOEXEC);
+
+  memset(&lock, 0, sizeof lock);
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  if (fcntl(hc->fd, F_SETLK, &lock)) {
+    if (EACCES == errno || EAGAIN == errno) {
+      errno = EBUSY;
+    }
+    goto failure;
+  }
+
+  if (fstat(hc->fd, &sb))
+    goto failure;
+
+  if (0 == sb.st_size) {
+    if (hashcache_init(hc))
+      goto failure;
+    return hc;
+  }
+
+  if (
+    (size_t) sb.st_size < sizeof header ||
+    (ssize_t) sizeof header != pread(hc->fd, &header, sizeof header, 0) ||
+    0 != memcmp(header.magic, HASHCACHE_MAGIC, sizeof header.magic)
+  ) {
+    errno = EINVAL;
+    goto failure;
+  }
+
+  if (
+    HASHCACHE_VERSION != header.version ||
+    sizeof *hc->slots != header.slot_size ||
+    HASHCACHE_ORDER != header.order ||
+    header.capacity < HASHCACHE_SLOTS_MIN ||
+    0 != (header.capacity & (header.capacity - 1)) ||
+    header.capacity > (sb.st_size - sizeof header) / sizeof *hc->slots
+  ) {
+    if (hashcache_init(hc))
+      goto failure;
+    return hc;
+  }
+
+  if (hashcache_map(hc, header.capacity))
+    goto failure;
+  return hc;
+
+failure:
+  error = errno;
+  hashcache_close(hc);
+  errno = error;
+  return NULL;
+}
+
+static bool
+hashcache_db_get(struct hashcache *hc, const struct hashcache_key *key,
+    struct hashcache_entry *e)
+{
+  const struct hashcache_slot *slot;
+  bool found = false;
+
+  hashcache_lock(hc);
+  if (hc->header) {
+    slot = hashcache_find(hc, key->dev, key->ino);
+    if (
+      0 != slot->digests &&
+      slot->size == key->size &&
+      slot->mtime == key->mtime &&
+      slot->ctime == key->ctime &&
+      slot->check == hashcache_check(slot)
+    ) {
+      e->digests = slot->digests;
+      memcpy(e->sha1, slot->sha1, sizeof e->sha1);
+      memcpy(e->tth, slot->tth, sizeof e->tth);
+      found = true;
+    }
+  }
+  hashcache_unlock(hc);
+  return found;
+}
+
+static void
+hashcache_db_put(struct hashcache *hc, const struct hashcache_key *key,
+    const struct hashcache_entry *e)
+{
+  struct hashcache_slot *slot, new_slot;
+
+  memset(&new_slot, 0, sizeof new_slot);
+  new_slot.dev = key->dev;
+  new_slot.ino = key->ino;
+  new_slot.size = key->size;
+  new_slot.mtime = key->mtime;
+  new_slot.ctime = key->ctime;
+  memcpy(new_slot.sha1, e->sha1, sizeof new_slot.sha1);
+  memcpy(new_slot.tth, e->tth, sizeof new_slot.tth);
+  new_slot.digests = e->digests;
+  new_slot.check = hashcache_check(&new_slot);
+
+  hashcache_lock(hc);
+  if (hc->header) {
+    slot = hashcache_find(hc, key->dev, key->ino);
+    if (0 == slot->digests) {
+      if (4 * (hc->header->count + 1) > 3 * hc->header->capacity) {
+        if (hashcache_grow(hc)) {
+          /* Without a mapping, the cache does nothing from now on */
+          if (hc->header) {
+            munmap(hc->header, hc->map_size);
+            hc->header = NULL;
+            hc->slots = NULL;
+          }
+          goto done;
+        }
+        slot = hashcache_find(hc, key->dev, key->ino);
+      }
+      hc->header->count++;
+    }
+    *slot = new_slot;
+  }
+
+done:
+  hashcache_unlock(hc);
+}
+
+/*
+ * Extended attributes
+ */
+
+/**
+ * Returns a cache which keeps the digests in an extended attribute of
+ * each file. As that changes the status change time, the key consists
+ * of the size and the modification time only.
+ *
+ * @return NULL on failure with errno set.
+ */
+struct hashcache *
+hashcache_xattr(void)
+{
+#ifdef HAVE_FGETXATTR
+  return hashcache_new();
+#else
+  errno = ENOTSUP;
+  return NULL;
+#endif /* HAVE_FGETXATTR */
+}
+
+/*
+ * The attribute holds a version, the digests present, the size, the
+ * modification time, the SHA-1 and the TTH, numbers in little-endian.
+ */
+static bool
+hashcache_xattr_get(int fd, const struct hashcache_key *key,
+    struct hashcache_entry *e)
+{
+#ifdef HAVE_FGETXATTR
+  unsigned char buf[HASHCACHE_XATTR_LEN];
+
+  if (
+    sizeof buf != fgetxattr(fd, HASHCACHE_XATTR, buf, sizeof buf) ||
+    HASHCACHE_VERSION != buf[0] ||
+    0 == buf[1] ||
+    peek_le64(&buf[2]) != key->size ||
+    (int64_t) peek_le64(&buf[10]) != key->mtime
+  ) {
+    return false;
+  }
+  e->digests = buf[1];
+  memcpy(e->sha1, &buf[18], sizeof e->sha1);
+  memcpy(e->tth, &buf[38], sizeof e->tth);
+  return true;
+#else
+  (void) fd;
+  (void) key;
+  (void) e;
+  return false;
+#endif /* HAVE_FGETXATTR */
+}
+
+static void
+hashcache_xattr_put(int fd, const struct hashcache_key *key,
+    const struct hashcache_entry *e)
+{
+#ifdef HAVE_FGETXATTR
+  unsigned char buf[HASHCACHE_XATTR_LEN];
+
+  buf[0] = HASHCACHE_VERSION;
+  buf[1] = e->digests;
+  poke_le64(&buf[2], key->size);
+  poke_le64(&buf[10], key->mtime);
+  memcpy(&buf[18], e->sha1, sizeof e->sha1);
+  memcpy(&buf[38], e->tth, sizeof e->tth);
+
+  /* Files which are read-only for this user are simply not cached */
+  (void) fsetxattr(fd, HASHCACHE_XATTR, buf, sizeof buf, 0);
+#else
+  (void) fd;
+  (void) key;
+  (void) e;
+#endif /* HAVE_FGETXATTR */
+}
+
+/**
+ * Looks up the digests of the file "fd" whose status gave "key".
+ *
+ * @return true if they were found, with "e" filled in.
+ */
+bool
+hashcache_get(struct hashcache *hc, int fd, const struct hashcache_key *key,
+    struct hashcache_entry *e)
+{
+  if (hc->fd < 0)
+    return hashcache_xattr_get(fd, key, e);
+  return hashcache_db_get(hc, key, e);
+}
+
+/**
+ * Stores the digests of the file "fd" whose status gave "key" before it
+ * was hashed. Failures are ignored, the file is hashed again next time.
+ */
+void
+hashcache_put(struct hashcache *hc, int fd, const struct hashcache_key *key,
+    const struct hashcache_entry *e)
+{
+  if (0 == e->digests)
+    return;
+
+  if (hc->fd < 0) {
+    if (key->mtime < hc->racy) {
+      hashcache_xattr_put(fd, key, e);
+    }
+  } else if (key->mtime < hc->racy && key->ctime < hc->racy) {
+    hashcache_db_put(hc, key, e);
+  }
+}
+
+/**
+ * Like hashcache_put() for a file which has been closed meanwhile. An
+ * attribute is only stored if the file at "path" still has the status
+ * which gave "key".
+ */
+void
+hashcache_put_path(struct hashcache *hc, const char *path,
+    const struct hashcache_key *key, const struct hashcache_entry *e)
+{
+  struct hashcache_key now;
+  struct stat sb;
+  int fd;
+
+  if (hc->fd >= 0) {
+    hashcache_put(hc, -1, key, e);
+    return;
+  }
+
+  fd = open(path, O_RDONLY, 0);
+  if (fd < 0)
+    return;
+
+  if (0 == fstat(fd, &sb)) {
+    hashcache_key(&now, &sb);
+    if (
+      now.dev == key->dev && now.ino == key->ino &&
+      now.size == key->size && now.mtime == key->mtime
+    ) {
+      hashcache_put(hc, fd, key, e);
+    }
+  }
+  close(fd);
+}
+
+/**
+ * Closes the cache and unlocks the database.
+ */
+void
+hashcache_close(struct hashcache *hc)
+{
+  if (hc) {
+    if (hc->header) {
+      munmap(hc->header, hc->map_size);
+    }
+    if (hc->fd >= 0) {
+      close(hc->fd);
+    }
+#ifdef HAVE_PTHREAD_SUPPORT
+    pthread_mutex_destroy(&hc->lock);
+#endif /* HAVE_PTHREAD_SUPPORT */
+    free(hc);
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef HASHCACHE_HEADER_FILE
+#define HASHCACHE_HEADER_FILE
+
+#include "common.h"
+
+/*
+ * A persistent cache of the SHA-1 and the TTH of regular files, so that
+ * unchanged files need not be hashed again. The digests are kept either
+ * in a database file which is mapped into memory, keyed by device, inode,
+ * size, modification and status change time, or in the extended attribute
+ * "user.bitprint" of each file, keyed by size and modification time.
+ *
+ * A file whose timestamps are less than HASHCACHE_RACY_NS older than the
+ * cache is opened is not stored, because it could be modified again
+ * without its timestamps changing.
+ */
+
+#define HASHCACHE_RACY_NS ((int64_t) 2 * 1000 * 1000 * 1000)
+
+enum hashcache_digest {
+  HASHCACHE_SHA1 = 1 << 0,
+  HASHCACHE_TTH  = 1 << 1
+};
+
+struct hashcache_key {
+  uint64_t dev, ino, size;
+  int64_t mtime, ctime;         /* nanoseconds since the epoch */
+};
+
+struct hashcache_entry {
+  unsigned digests;             /* enum hashcache_digest */
+  unsigned char sha1[20];
+  char tth[24];
+};
+
+struct hashcache;
+
+struct hashcache *hashcache_open(const char *path);
+struct hashcache *hashcache_xattr(void);
+void hashcache_key(struct hashcache_key *key, const struct stat *sb);
+bool hashcache_get(struct hashcache *hc, int fd,
+    const struct hashcache_key *key, struct hashcache_entry *e);
+void hashcache_put(struct hashcache *hc, int fd,
+    const struct hashcache_key *key, const struct hashcache_entry *e);
+void hashcache_put_path(struct hashcache *hc, const char *path,
+    const struct hashcache_key *key, const struct hashcache_entry *e);
+void hashcache_close(struct hashcache *hc);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* HASHCACHE_HEADER_FILE */
@@ -0,0 +1,1201 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "hasher.h"
+#include "base32.h"
+#include "bitprint.h"
+#include "compat_sha1.h"
+#include "tiger.h"
+#include "tigertree.h"
+#include "uring.h"
+#include "walk.h"
+
+/*
+ * Small regular files are read completely and hashed in batches so that
+ * the SHA-1 of several files is calculated at once, see sha1_multi().
+ */
+#define BATCH_FILES     64
+#define BATCH_FILE_MAX  (128 * 1024)
+#define BATCH_SIZE      (1024 * 1024)
+
+/*
+ * File descriptors kept for the standard streams, the list and the cache.
+ * Each thread needs a few more for its ring, the file it hashes and a
+ * directory; the rest is shared by the batches of the threads.
+ */
+#define FDS_RESERVED    16
+#define FDS_PER_THREAD  3
+
+/* Size of the page-aligned buffer used with --nocache and for small files */
+#define READ_BUFSIZE    (1024 * 1024)
+
+/*
+ * A regular file of less than READ_BUFSIZE bytes is read with a single
+ * pread() and its TTH built from memory. Up to one TTH leaf, the file is
+ * read into a buffer on the stack.
+ */
+#define SMALL_FILE_MAX  (READ_BUFSIZE - 1)
+
+/* The entries of a directory are passed on in groups of WALK_GROUP */
+#define WALK_GROUP      64
+
+/*
+ * With a ring, the files of a batch are read asynchronously and each
+ * file is closed as soon as its read is complete, so that no more than
+ * h->fds files are open at once.
+ */
+struct batch {
+  struct job *job[BATCH_FILES];
+  const void *data[BATCH_FILES];
+  size_t size[BATCH_FILES];
+  size_t room[BATCH_FILES];     /* bytes asked for by an asynchronous read */
+  int fd[BATCH_FILES];          /* file being read or -1 */
+  int error[BATCH_FILES];       /* errno of an asynchronous read or 0 */
+  bool keyed[BATCH_FILES];      /* "key" is set for the cache */
+  struct hashcache_key key[BATCH_FILES];
+  struct sha1 sha1[BATCH_FILES];
+  size_t n;                     /* number of files */
+  size_t used;                  /* bytes of "buf" in use */
+  unsigned reading;             /* asynchronous reads in flight */
+  unsigned open;                /* files in "fd" */
+  uint64_t buf[BATCH_SIZE / sizeof(uint64_t)];
+};
+
+/*
+ * The state of one hashing thread.
+ */
+struct hasher {
+  const struct options *opt;
+  struct pool *pool;
+  struct uring *ring;
+  struct hashcache *cache;      /* shared by all threads or NULL */
+  struct tt_thex *thex;         /* collects the THEX tree or NULL */
+  unsigned jobs;                /* threads for a single file */
+  unsigned fds;                 /* files the batch may keep open */
+  bool mmap;                    /* bitprint_mmap() may be used */
+  char *read_buf;               /* READ_BUFSIZE bytes, page-aligned */
+  uint64_t buf[4 * 1024];       /* 32 KiB */
+  struct batch batch;
+};
+
+/*
+ * Starts hashing the TTH of a regular file on "jobs" threads if it is
+ * large enough to be worth it.
+ */
+static struct tt_parallel *
+get_tth_parallel(int fd, const struct stat *sb, unsigned jobs, bool nocache)
+{
+  off_t offset;
+
+  if (jobs < 2)
+    return NULL;
+
+  offset = lseek(fd, 0, SEEK_CUR);
+  if ((off_t) -1 == offset || sb->st_size - offset < 2 * TT_PARALLEL_CHUNK)
+    return NULL;
+
+  return tt_parallel_file(fd, offset, sb->st_size - offset, jobs, nocache);
+}
+
+/**
+ * Turns O_DIRECT on or off for "fd".
+ *
+ * @return 0 on success, -1 on failure.
+ */
+static int
+set_direct_io(int fd, bool on)
+{
+#ifdef HAVE_O_DIRECT
+  int flags;
+
+  flags = fcntl(fd, F_GETFL);
+  if (-1 == flags)
+    return -1;
+  flags = on ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+  return fcntl(fd, F_SETFL, flags) ? -1 : 0;
+#else
+  (void) fd;
+  (void) on;
+  errno = ENOSYS;
+  return -1;
+#endif /* HAVE_O_DIRECT */
+}
+
+/**
+ * Drops the given range of "fd" from the page cache; a length of zero
+ * means up to the end of the file.
+ */
+static void
+drop_cache(int fd, off_t offset, off_t len)
+{
+#ifdef POSIX_FADV_DONTNEED
+  posix_fadvise(fd, offset, len, POSIX_FADV_DONTNEED);
+#else
+  (void) fd;
+  (void) offset;
+  (void) len;
+#endif /* POSIX_FADV_DONTNEED */
+}
+
+/**
+ * Hashes "len" bytes of "fd" from "offset" on, with io_uring if there is
+ * a ring and else with pread().
+ *
+ * @return 0 on success, -1 on failure with errno set.
+ */
+static int
+hash_range(struct hasher *h, int fd, uint64_t offset, uint64_t len,
+    struct compat_sha1 *sha1, TT_CONTEXT *tt, struct tiger_ctx *tiger)
+{
+  uint64_t done = 0;
+
+  if (h->ring) {
+    off_t pos;
+
+    if (bitprint_uring(h->ring, fd, offset, len, sha1, tt, tiger))
+      return -1;
+    pos = lseek(fd, 0, SEEK_CUR);
+    if ((off_t) -1 == pos)
+      return -1;
+    done = pos - offset;
+  }
+
+  while (done < len) {
+    ssize_t ret;
+
+    ret = pread(fd, h->buf, MIN(sizeof h->buf, len - done), offset + done);
+    if ((ssize_t) -1 == ret) {
+      if (EINTR == errno || EAGAIN == errno)
+        continue;
+      return -1;
+    } else if (0 == ret) {
+      errno = EIO; /* the file was truncated meanwhile */
+      return -1;
+    }
+    bitprint_update(sha1, tt, tiger, h->buf, (size_t) ret);
+    done += (size_t) ret;
+  }
+  return 0;
+}
+
+/**
+ * @return the page-aligned buffer of READ_BUFSIZE bytes of "h", which is
+ * allocated on first use, or NULL if that fails.
+ */
+static char *
+hasher_read_buf(struct hasher *h)
+{
+  if (!h->read_buf) {
+    h->read_buf = compat_page_align(READ_BUFSIZE);
+  }
+  return h->read_buf;
+}
+
+/**
+ * Calculates the TTH of "len" bytes in memory, at most SMALL_FILE_MAX,
+ * one level of the tree at a time.
+ */
+static void
+get_tth_buffer(struct hasher *h, const void *data, size_t len,
+    struct tth *tth)
+{
+  char (*leaves)[TIGERSIZE] = (void *) h->buf;
+  size_t n;
+
+  STATIC_ASSERT(
+    (SMALL_FILE_MAX / TTH_BLOCKSIZE + 1) * TIGERSIZE <= sizeof h->buf
+  );
+  RUNTIME_ASSERT(len <= SMALL_FILE_MAX);
+
+  n = tt_leaves(data, len, leaves);
+  tt_combine(leaves, n, tth->data);
+}
+
+/**
+ * Reads up to "size" bytes of "fd" from "offset" on into "buf".
+ *
+ * @return the number of bytes read, less than "size" only at the end of
+ * the file, or -1 on failure with errno set.
+ */
+static ssize_t
+read_fully(int fd, void *buf, size_t size, off_t offset)
+{
+  char *p = buf;
+  size_t done = 0;
+
+  while (done < size) {
+    ssize_t ret;
+
+    ret = pread(fd, &p[done], size - done, offset + done);
+    if (0 == ret) {
+      break;
+    } else if ((ssize_t) -1 != ret) {
+      done += ret;
+    } else if (EINTR != errno && EAGAIN != errno) {
+      return -1;
+    }
+  }
+  return done;
+}
+
+/*
+ * The hashes of a small regular file are calculated from a single read
+ * without setting up any contexts for streaming. The buffer is one byte
+ * larger than the file to notice if it has grown meanwhile.
+ *
+ * @return 0 on success, -1 on failure and 1 if the file must be hashed
+ * the usual way after all.
+ */
+static int
+get_sums_small(struct hasher *h, int fd, const char *filename,
+    off_t offset, size_t size,
+    struct tth *tth, struct sha1 *sha1, struct tiger_hash *tiger_md)
+{
+  char leaf[1 + TTH_BLOCKSIZE + 1];
+  char *data;
+  ssize_t ret;
+
+  if (size <= TTH_BLOCKSIZE) {
+    /* The prefix of a leaf is put in front so that it is hashed in one go */
+    leaf[0] = 0x00;
+    data = &leaf[1];
+  } else {
+    data = hasher_read_buf(h);
+    if (!data)
+      return 1;
+  }
+
+  ret = read_fully(fd, data, size + 1, offset);
+  if ((ssize_t) -1 == ret) {
+    print_error("pread", filename, errno);
+    return -1;
+  }
+  if ((size_t) ret > size)
+    return 1;
+  size = ret;
+
+  if (h->opt->nocache) {
+    drop_cache(fd, 0, 0);
+  }
+
+  if (sha1) {
+    struct compat_sha1 ctx;
+
+    compat_sha1_init(&ctx);
+    compat_sha1_update(&ctx, data, size);
+    compat_sha1_final(&ctx, sha1);
+  }
+  if (tth) {
+    if (data == &leaf[1] && size <= TTH_BLOCKSIZE) {
+      tiger(leaf, 1 + size, tth->data);
+    } else {
+      get_tth_buffer(h, data, size, tth);
+    }
+  }
+  if (tiger_md) {
+    tiger(data, size, tiger_md->data);
+  }
+  return 0;
+}
+
+/*
+ * The SHA-1 and the Tiger hash of a large file are calculated by this
+ * thread from the front to the back, subtree by subtree, and so is the
+ * TTH, except for the subtrees which idle threads steal from the back.
+ */
+static int
+get_sums_split(struct hasher *h, int fd, const char *filename,
+    struct tt_parallel *tp, uint64_t offset, uint64_t size,
+    struct tth *tth, struct sha1 *sha1, struct tiger_hash *tiger)
+{
+  struct compat_sha1 sha1_ctx;
+  struct tiger_ctx tiger_ctx;
+  uint64_t pos, chunk = tt_parallel_chunk(tp);
+  size_t i;
+  int result = 0;
+
+  if (sha1) {
+    compat_sha1_init(&sha1_ctx);
+  }
+  if (tiger) {
+    tiger_init(&tiger_ctx);
+  }
+
+  pool_split_add(h->pool, tp);
+  for (i = 0, pos = 0; pos < size; i++, pos += chunk) {
+    TT_CONTEXT tt_ctx;
+    bool claimed;
+
+    claimed = tt_parallel_claim(tp, i);
+    if (!claimed && !sha1 && !tiger)
+      continue;
+
+    if (claimed) {
+      tt_init(&tt_ctx);
+    }
+    if (
+      hash_range(h, fd, offset + pos, MIN(chunk, size - pos),
+        sha1 ? &sha1_ctx : NULL, claimed ? &tt_ctx : NULL,
+        tiger ? &tiger_ctx : NULL)
+    ) {
+      print_error("read", filename, errno);
+      result = -1;
+      break;
+    }
+    if (h->opt->nocache) {
+      drop_cache(fd, offset + pos, MIN(chunk, size - pos));
+    }
+    if (claimed) {
+      char root[TIGERSIZE];
+
+      tt_digest(&tt_ctx, root);
+      tt_parallel_root(tp, i, root);
+    }
+  }
+  pool_split_remove(h->pool, tp);
+
+  /* The subtrees which were stolen must be waited for in any case */
+  if (tt_parallel_finish(tp, tth->data) && 0 == result) {
+    print_error("pread", filename, errno);
+    result = -1;
+  }
+  if (0 != result) {
+    return -1;
+  }
+
+  if (sha1) {
+    compat_sha1_final(&sha1_ctx, sha1);
+  }
+  if (tiger) {
+    tiger_final(&tiger_ctx, tiger->data);
+  }
+  return 0;
+}
+
+/*
+ * With --nocache, a regular file is read with O_DIRECT if possible and
+ * else dropped from the page cache behind the reads, so that hashing
+ * large amounts of data does not evict everything else.
+ */
+int
+hasher_sums(struct hasher *h, int fd, const char *filename,
+    struct tth *tth, struct sha1 *sha1, struct tiger_hash *tiger)
+{
+  unsigned jobs = h->jobs;
+  bool nocache = h->opt->nocache;
+  struct compat_sha1 sha1_ctx;
+  struct tiger_ctx tiger_ctx;
+  struct tt_parallel *tp = NULL;
+  struct tt_stream *ts = NULL;
+  struct bitprint_pipe *bp = NULL;
+  TT_CONTEXT tt_ctx;
+  struct stat sb;
+  size_t page = compat_getpagesize();
+  off_t pos = -1;               /* file offset to drop behind or -1 */
+  bool tt_serial, direct = false;
+  bool thex = tth && h->thex;   /* the tree needs a single context */
+  int result = 0;
+
+  if (fstat(fd, &sb)) {
+    print_error("fstat", filename, errno);
+    return -1;
+  }
+
+  if (S_ISREG(sb.st_mode) && sb.st_size <= SMALL_FILE_MAX && !thex) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+
+    if ((off_t) -1 != offset && offset <= sb.st_size) {
+      result = get_sums_small(h, fd, filename, offset, sb.st_size - offset,
+          tth, sha1, tiger);
+      if (result <= 0)
+        return result;
+      result = 0;
+    }
+  }
+
+  if (
+    tth && !thex && S_ISREG(sb.st_mode) && h->pool && pool_workers(h->pool) > 1
+  ) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+
+    if ((off_t) -1 != offset && sb.st_size - offset >= 2 * TT_PARALLEL_CHUNK) {
+      tp = tt_parallel_file(fd, offset, sb.st_size - offset, 1, nocache);
+      if (tp) {
+        return get_sums_split(h, fd, filename, tp, offset,
+            sb.st_size - offset, tth, sha1, tiger);
+      }
+    }
+  }
+
+  if (sha1) {
+    compat_sha1_init(&sha1_ctx);
+  }
+  if (tth && !thex) {
+    if (S_ISREG(sb.st_mode)) {
+      /* With --nocache, the threads must not read the file a second time */
+      if (!nocache || !(sha1 || tiger)) {
+        tp = get_tth_parallel(fd, &sb, jobs, nocache);
+      }
+    } else if (jobs > 1) {
+      /* A pipe or the like is read straight into the subtree buffers */
+      ts = tt_stream_new(jobs);
+    }
+  }
+  tt_serial = tth && !tp && !ts;
+  if (thex) {
+    tt_init_thex(&tt_ctx, h->thex);
+  } else if (tt_serial) {
+    tt_init(&tt_ctx);
+  }
+  if (tiger) {
+    tiger_init(&tiger_ctx);
+  }
+
+  /*
+   * With several jobs, the hashes which would otherwise be calculated one
+   * after another by this thread get a thread each.
+   */
+  if (jobs > 1 && !ts && (NULL != sha1) + tt_serial + (NULL != tiger) > 1) {
+    bp = bitprint_pipe_new(sha1 ? &sha1_ctx : NULL,
+        tt_serial ? &tt_ctx : NULL, tiger ? &tiger_ctx : NULL);
+  }
+
+  /* O_DIRECT requires aligned offsets, so it is tried from one only */
+  if (nocache && S_ISREG(sb.st_mode) && !tp) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+
+    direct = (off_t) -1 != offset && 0 == offset % page &&
+      0 == set_direct_io(fd, true);
+  }
+
+  /*
+   * A regular file is read with io_uring or else hashed from memory
+   * mappings as far as possible.
+   */
+  if (S_ISREG(sb.st_mode) && !bp && (sha1 || tiger || tt_serial)) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    int ret = 0;
+
+    if ((off_t) -1 == offset || sb.st_size <= offset) {
+      /* Nothing to do */
+    } else if (h->ring && (direct || !nocache)) {
+      ret = bitprint_uring(h->ring, fd, offset, sb.st_size - offset,
+          sha1 ? &sha1_ctx : NULL, tt_serial ? &tt_ctx : NULL,
+          tiger ? &tiger_ctx : NULL);
+    } else if (
+      h->mmap && !nocache && sb.st_size - offset >= BITPRINT_MMAP_MIN
+    ) {
+      ret = bitprint_mmap(fd, offset, sb.st_size - offset,
+          sha1 ? &sha1_ctx : NULL, tt_serial ? &tt_ctx : NULL,
+          tiger ? &tiger_ctx : NULL);
+    }
+    if (ret) {
+      print_error("lseek", filename, errno);
+      result = -1;
+    }
+  }
+
+  if (nocache && S_ISREG(sb.st_mode)) {
+    pos = lseek(fd, 0, SEEK_CUR);
+  }
+
+  /* Unless the TTH is all there is and it is being hashed in parallel */
+  while (0 == result && (sha1 || tiger || (tth && !tp))) {
+    void *data = h->buf;
+    size_t size = sizeof h->buf;
+    ssize_t ret;
+
+    if (ts) {
+      data = tt_stream_space(ts, &size);
+    } else if (bp) {
+      data = bitprint_pipe_space(bp, &size);
+    } else if (nocache) {
+      data = hasher_read_buf(h);
+      if (data) {
+        size = READ_BUFSIZE;
+      } else {
+        data = h->buf;
+      }
+    }
+    if (direct && (0 != size % page || 0 != PTR2UINT(data) % page)) {
+      set_direct_io(fd, false);
+      direct = false;
+    }
+
+    ret = read(fd, data, size);
+    if (0 == ret) {
+      break;
+    } else if ((ssize_t) -1 != ret) {
+      if ((off_t) -1 != pos) {
+        if (!direct) {
+          drop_cache(fd, pos, ret);
+        }
+        pos += ret;
+      }
+      if (bp) {
+        bitprint_pipe_commit(bp, (size_t) ret);
+        continue;
+      }
+      bitprint_update(sha1 ? &sha1_ctx : NULL, tt_serial ? &tt_ctx : NULL,
+          tiger ? &tiger_ctx : NULL, data, (size_t) ret);
+      if (ts) {
+        tt_stream_commit(ts, (size_t) ret);
+      }
+    } else if (direct && EINVAL == errno) {
+      /* The file system does not support O_DIRECT after all */
+      set_direct_io(fd, false);
+      direct = false;
+    } else if (EINTR != errno && EAGAIN != errno) {
+      print_error("read", filename, errno);
+      result = -1;
+      break;
+    }
+  }
+  if (direct) {
+    set_direct_io(fd, false);
+  }
+
+  if (bp) {
+    bitprint_pipe_finish(bp);
+  }
+  if (tp) {
+    /* The threads must be waited for even if read() failed */
+    if (tt_parallel_finish(tp, tth->data)) {
+      print_error("pread", filename, errno);
+      result = -1;
+    }
+  }
+  if (ts) {
+    tt_stream_digest(ts, tth->data);
+  }
+  if (0 != result) {
+    return -1;
+  }
+
+  if (sha1) {
+    compat_sha1_final(&sha1_ctx, sha1);
+  }
+  if (tt_serial) {
+    tt_digest(&tt_ctx, tth->data);
+  }
+  if (tiger) {
+    tiger_final(&tiger_ctx, tiger->data);
+  }
+
+  return 0;
+}
+
+/**
+ * @return the THEX tree collected by the last hasher_sums() as an allocated
+ * string "DEPTH:BASE32", the serialized tree padded to whole base32
+ * groups.
+ */
+char *
+hasher_thex(const struct hasher *h)
+{
+  const char *tree;
+  unsigned depth;
+  size_t size, len, n;
+  char *s;
+
+  tree = tt_thex_tree(h->thex, &size, &depth);
+  len = (size + 4) / 5 * 8;
+  s = malloc(16 + len);
+  if (!s) {
+    print_error("malloc", NULL, errno);
+    exit(EXIT_FAILURE);
+  }
+  n = snprintf(s, 16, "%u:", depth);
+  len = n + base32_encode(&s[n], len, tree, size);
+  while (0 != (len - n) % 8) {
+    s[len++] = '=';
+  }
+  s[len] = '\0';
+  return s;
+}
+
+/**
+ * Looks up the digests of "job" in the cache and, failing that, fills in
+ * "key" to put them there once they are known.
+ *
+ * @return 1 if all digests asked for were found, 0 if not and -1 if the
+ * file cannot be cached.
+ */
+static int
+cache_get(struct hasher *h, int fd, struct job *job,
+    struct hashcache_key *key)
+{
+  struct hashcache_entry e;
+  unsigned wanted;
+  struct stat sb;
+
+  if (fstat(fd, &sb) || !S_ISREG(sb.st_mode))
+    return -1;
+
+  hashcache_key(key, &sb);
+
+  /* The Tiger hash of the whole file is not cached */
+  if (job->digests & DIGEST_TIGER)
+    return 0;
+
+  wanted = (job_sha1(job) ? HASHCACHE_SHA1 : 0) |
+    (job_tth(job) ? HASHCACHE_TTH : 0);
+  if (
+    !hashcache_get(h->cache, fd, key, &e) ||
+    wanted != (e.digests & wanted)
+  ) {
+    return 0;
+  }
+
+  if (job_sha1(job)) {
+    memcpy(job->sha1.data, e.sha1, sizeof job->sha1.data);
+  }
+  if (job_tth(job)) {
+    memcpy(job->tth.data, e.tth, sizeof job->tth.data);
+  }
+  return 1;
+}
+
+/**
+ * Puts the digests of "job" in the cache under "key". "fd" is the file
+ * or -1 if it has been closed already.
+ */
+static void
+cache_put(struct hasher *h, int fd, const struct job *job,
+    const struct hashcache_key *key)
+{
+  struct hashcache_entry e;
+
+  memset(&e, 0, sizeof e);
+  if (job->digests & DIGEST_SHA1) {
+    e.digests |= HASHCACHE_SHA1;
+    memcpy(e.sha1, job->sha1.data, sizeof e.sha1);
+  }
+  if (job->digests & DIGEST_TTH) {
+    e.digests |= HASHCACHE_TTH;
+    memcpy(e.tth, job->tth.data, sizeof e.tth);
+  }
+  if (fd < 0) {
+    hashcache_put_path(h->cache, job->filename, key, &e);
+  } else {
+    hashcache_put(h->cache, fd, key, &e);
+  }
+}
+
+/**
+ * Closes the file of the batch entry "i" once it has been read.
+ */
+static void
+batch_close(struct hasher *h, size_t i)
+{
+  struct batch *b = &h->batch;
+  int fd = b->fd[i];
+
+  if (fd >= 0) {
+    if (h->opt->nocache) {
+      drop_cache(fd, 0, 0);
+    }
+    close(fd);
+    b->fd[i] = -1;
+    b->open--;
+  }
+}
+
+/**
+ * Waits for the completion of one of the asynchronous reads of the batch.
+ */
+static void
+batch_reap(struct hasher *h)
+{
+  struct batch *b = &h->batch;
+  uint64_t i;
+  int res;
+
+  if (uring_wait(h->ring, &i, &res)) {
+    print_error("io_uring_enter", NULL, errno);
+    exit(EXIT_FAILURE);
+  }
+  if (res > 0) {
+    b->size[i] += res;
+  }
+
+  /*
+   * A read which stops one byte short has reached the end of the file, so
+   * the final read of zero bytes is not waited for.
+   */
+  if (
+    (res > 0 && b->size[i] < b->room[i] - 1) ||
+    -EINTR == res || -EAGAIN == res
+  ) {
+    char *p = deconstify_void_ptr(b->data[i]);
+
+    if (
+      0 == uring_read(h->ring, b->fd[i], &p[b->size[i]],
+        b->room[i] - b->size[i], b->size[i], i)
+    ) {
+      return;
+    }
+    res = -errno;
+  }
+  if (res < 0) {
+    b->error[i] = -res;
+  }
+  b->reading--;
+  batch_close(h, i);
+}
+
+/**
+ * Hashes all files of the batch, passes them on to the pool and empties
+ * the batch.
+ */
+static void
+batch_flush(struct hasher *h)
+{
+  const struct options *opt = h->opt;
+  struct batch *b = &h->batch;
+  size_t i;
+
+  while (b->reading > 0) {
+    batch_reap(h);
+  }
+
+  /* Only files whose SHA-1 is asked for are batched */
+  compat_sha1_multi(b->data, b->size, b->n, b->sha1);
+  for (i = 0; i < b->n; i++) {
+    struct job *job = b->job[i];
+    int fd = b->fd[i];
+
+    if (fd >= 0) {
+      b->fd[i] = -1;
+      b->open--;
+      if (opt->nocache) {
+        drop_cache(fd, 0, 0);
+      }
+    }
+    if (b->error[i]) {
+      print_error("read", job->filename, b->error[i]);
+      pool_done(h->pool, job, false);
+      if (fd >= 0) {
+        close(fd);
+      }
+      continue;
+    }
+    if (b->size[i] == b->room[i]) {
+      bool ok = false;
+
+      /* The file has grown meanwhile, so it is hashed on its own */
+      if (fd >= 0) {
+        close(fd);
+      }
+      fd = open(job->filename, O_RDONLY, 0);
+      if (fd < 0) {
+        print_error("open", job->filename, errno);
+      } else {
+        ok = 0 == hasher_sums(h, fd, job->filename,
+            job_tth(job), job_sha1(job), job_tiger(job));
+        close(fd);
+      }
+      pool_done(h->pool, job, ok);
+      continue;
+    }
+
+    job->sha1 = b->sha1[i];
+    if (job_tth(job)) {
+      get_tth_buffer(h, b->data[i], b->size[i], &job->tth);
+    }
+    if (job_tiger(job)) {
+      tiger(b->data[i], b->size[i], job->tiger.data);
+    }
+    if (b->keyed[i]) {
+      cache_put(h, -1, job, &b->key[i]);
+    }
+    pool_done(h->pool, job, true);
+  }
+  b->n = 0;
+  b->used = 0;
+}
+
+/**
+ * Reads a small regular file completely into the batch, flushing the
+ * batch first if it is full. With a ring, the read is only started. If
+ * "key" is not NULL, the digests are put in the cache under it.
+ *
+ * @return 1 if the file was added, 0 if it is not suitable and must be
+ * hashed on its own and -1 if reading failed. In the first case the batch
+ * takes care of closing "fd".
+ */
+static int
+batch_add(struct hasher *h, int fd, struct job *job,
+    const struct hashcache_key *key)
+{
+  struct batch *b = &h->batch;
+  struct stat sb;
+  size_t size = 0, room;
+  char *p;
+
+  if (fstat(fd, &sb) || !S_ISREG(sb.st_mode) || sb.st_size > BATCH_FILE_MAX)
+    return 0;
+
+  /* One byte more to notice if the file has grown meanwhile */
+  room = sb.st_size + 1;
+  if (b->n == BATCH_FILES || sizeof b->buf - b->used < room) {
+    batch_flush(h);
+  }
+
+  p = (char *) b->buf + b->used;
+  if (h->ring) {
+    /* The files being read count against the budget of open files */
+    while (b->reading > 0 && b->open >= h->fds) {
+      batch_reap(h);
+    }
+    if (b->open >= h->fds) {
+      batch_flush(h);
+      p = (char *) b->buf + b->used;
+    }
+    if (b->reading == uring_depth(h->ring)) {
+      batch_reap(h);
+    }
+    if (0 == uring_read(h->ring, fd, p, room, 0, b->n)) {
+      b->job[b->n] = job;
+      b->data[b->n] = p;
+      b->size[b->n] = 0;
+      b->room[b->n] = room;
+      b->fd[b->n] = fd;
+      b->error[b->n] = 0;
+      b->keyed[b->n] = NULL != key;
+      if (key) {
+        b->key[b->n] = *key;
+      }
+      b->n++;
+      b->used += room;
+      b->reading++;
+      b->open++;
+      return 1;
+    }
+  }
+
+  while (size < room) {
+    ssize_t ret;
+
+    ret = read(fd, &p[size], room - size);
+    if (0 == ret) {
+      break;
+    } else if ((ssize_t) -1 != ret) {
+      size += ret;
+    } else if (EINTR != errno && EAGAIN != errno) {
+      print_error("read", job->filename, errno);
+      return -1;
+    }
+  }
+  if (size == room) {
+    if ((off_t) -1 == lseek(fd, 0, SEEK_SET)) {
+      print_error("lseek", job->filename, errno);
+      return -1;
+    }
+    return 0;
+  }
+
+  /* The cache only needs the key, which was taken when it was opened */
+  if (h->opt->nocache) {
+    drop_cache(fd, 0, 0);
+  }
+  close(fd);
+  b->fd[b->n] = -1;
+  b->keyed[b->n] = NULL != key;
+  if (key) {
+    b->key[b->n] = *key;
+  }
+  b->job[b->n] = job;
+  b->data[b->n] = p;
+  b->size[b->n] = size;
+  b->room[b->n] = room;
+  b->error[b->n] = 0;
+  b->n++;
+  b->used += size;
+  return 1;
+}
+
+/**
+ * Creates the state of a hashing thread which hashes each file with
+ * "jobs" threads. bitprint_mmap() is only safe if "mmap" is true.
+ */
+struct hasher *
+hasher_new(const struct options *opt, struct pool *pool, unsigned jobs,
+    bool mmap)
+{
+  struct hasher *h;
+
+  h = calloc(1, sizeof *h);
+  if (!h) {
+    print_error("calloc", NULL, errno);
+    exit(EXIT_FAILURE);
+  }
+  h->opt = opt;
+  h->pool = pool;
+  h->jobs = jobs;
+  h->mmap = mmap;
+  h->fds = BATCH_FILES;
+
+  /* Without io_uring, regular files are hashed from memory mappings */
+  if (opt->depth > 0) {
+    h->ring = uring_new(opt->depth, h->batch.buf, sizeof h->batch.buf);
+  }
+  if (opt->thex > 0) {
+    h->thex = tt_thex_new(opt->thex);
+    if (!h->thex) {
+      print_error("tt_thex_new", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
+  return h;
+}
+
+void
+hasher_free(struct hasher *h)
+{
+  if (h) {
+    uring_free(h->ring);
+    tt_thex_free(h->thex);
+    if (h->read_buf) {
+      compat_page_free(h->read_buf, READ_BUFSIZE);
+    }
+    free(h);
+  }
+}
+
+static void
+hash_file(struct hasher *h, struct job *job)
+{
+  const struct options *opt = h->opt;
+  struct hashcache_key key;
+  int fd, ret = 0, cached = -1;
+
+  fd = open(job->filename, O_RDONLY, 0);
+  if (fd < 0 && EMFILE == errno) {
+    /* The files held by the batch are closed once it is flushed */
+    batch_flush(h);
+    fd = open(job->filename, O_RDONLY, 0);
+  }
+  if (fd < 0) {
+    if (opt->check && (ENOENT == errno || ENOTDIR == errno)) {
+      job->missing = true;
+    } else {
+      print_error("open", job->filename, errno);
+    }
+    pool_done(h->pool, job, false);
+    return;
+  }
+
+  if (h->cache) {
+    cached = cache_get(h, fd, job, &key);
+    if (1 == cached) {
+      close(fd);
+      pool_done(h->pool, job, true);
+      return;
+    }
+  }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif  /* POSIX_FADV_SEQUENTIAL */
+
+  /* Batching pays off for the SHA-1 only, the tree needs hasher_sums() */
+  if (job_sha1(job) && !h->thex) {
+    ret = batch_add(h, fd, job, 0 == cached ? &key : NULL);
+  }
+  if (0 == ret) {
+    bool ok;
+
+    batch_flush(h); /* don't hold back the results before this one */
+    ok = 0 == hasher_sums(h, fd, job->filename,
+        job_tth(job), job_sha1(job), job_tiger(job));
+    if (ok && 0 == cached) {
+      cache_put(h, fd, job, &key);
+    }
+    if (ok && h->thex) {
+      job->thex = hasher_thex(h);
+    }
+    pool_done(h->pool, job, ok);
+  } else if (ret < 0) {
+    pool_done(h->pool, job, false);
+  }
+  if (1 != ret) {
+    close(fd);
+  }
+}
+
+/**
+ * Reads the directory of "dir" and inserts its regular files and
+ * subdirectories in its place.
+ */
+static void
+walk_dir(struct hasher *h, struct job *dir)
+{
+  struct pool *p = h->pool;
+  struct job *at = dir, *first = NULL, **last = &first;
+  struct walk_dir *wd;
+  struct walk_entry e;
+  unsigned n = 0;
+  int ret;
+
+  wd = walk_open(dir->filename, h->opt->follow);
+  if (!wd) {
+    print_error("open", dir->filename, errno);
+    pool_done(p, dir, false);
+    return;
+  }
+
+  /* Symbolic links may lead back to a directory */
+  if (h->opt->follow) {
+    uint64_t dev, ino;
+
+    if (0 == walk_id(wd, &dev, &ino) && pool_seen(p, dev, ino)) {
+      walk_close(wd);
+      pool_done(p, dir, true);
+      return;
+    }
+  }
+
+  while (1 == (ret = walk_read(wd, &e))) {
+    struct job *job;
+
+    job = job_new(p, dir->filename, e.name, WALK_DIR == e.type);
+
+    /* Only the first link of a file is hashed */
+    if (e.linked) {
+      pool_link(p, job, e.dev, e.ino);
+    }
+    *last = job;
+    last = &job->next;
+    if (++n == WALK_GROUP) {
+      at = pool_insert(p, at, first, last);
+      first = NULL;
+      last = &first;
+      n = 0;
+    }
+  }
+  if (ret) {
+    print_error("getdents", dir->filename, errno);
+  }
+  if (first) {
+    pool_insert(p, at, first, last);
+  }
+  walk_close(wd);
+  pool_done(p, dir, 0 == ret);
+}
+
+static void *
+hasher_run(void *arg)
+{
+  struct hasher *h = arg;
+
+  for (;;) {
+    struct job *job;
+
+    job = pool_next(h->pool, false);
+    if (!job) {
+      batch_flush(h); /* don't hold back results while waiting */
+      job = pool_next(h->pool, true);
+      if (!job)
+        break;
+    }
+    if (job->dir) {
+      walk_dir(h, job);
+    } else {
+      hash_file(h, job);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @return the number of files the batch of each of "workers" threads may
+ * keep open within the limit of open files, at least one.
+ */
+static unsigned
+batch_fds(unsigned workers)
+{
+  struct rlimit rl;
+  rlim_t n;
+
+  if (getrlimit(RLIMIT_NOFILE, &rl) || RLIM_INFINITY == rl.rlim_cur)
+    return BATCH_FILES;
+
+  n = rl.rlim_cur > FDS_RESERVED ? (rl.rlim_cur - FDS_RESERVED) / workers : 0;
+  n = n > FDS_PER_THREAD ? n - FDS_PER_THREAD : 1;
+  return MIN(n, BATCH_FILES);
+}
+
+/**
+ * Hashes the jobs of "pool" on pool_workers() threads including the
+ * calling one, which share "cache" unless it is NULL. A single thread
+ * hashes each file with opt->jobs threads. Otherwise each thread takes
+ * one file after another and, once there are none left, helps with the
+ * large files of the others.
+ */
+void
+hash_pool(struct pool *pool, const struct options *opt,
+    struct hashcache *cache)
+{
+  struct hasher *hashers[JOBS_MAX];
+  unsigned i, workers = pool_workers(pool);
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_t threads[JOBS_MAX];
+  unsigned started;
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+  RUNTIME_ASSERT(workers > 0 && workers <= JOBS_MAX);
+
+  /* The SIGBUS handler of bitprint_mmap() cannot be shared by threads */
+  for (i = 0; i < workers; i++) {
+    hashers[i] = hasher_new(opt, pool, 1 == workers ? opt->jobs : 1,
+        1 == workers);
+    hashers[i]->cache = cache;
+    hashers[i]->fds = batch_fds(workers);
+  }
+
+#ifdef HAVE_PTHREAD_SUPPORT
+  for (started = 1; started < workers; started++) {
+    if (pthread_create(&threads[started], NULL, hasher_run, hashers[started]))
+      break;
+  }
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+  hasher_run(hashers[0]);
+
+#ifdef HAVE_PTHREAD_SUPPORT
+  for (i = 1; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+  for (i = 0; i < workers; i++) {
+    hasher_free(hashers[i]);
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef HASHER_HEADER_FILE
+#define HASHER_HEADER_FILE
+
+#include "pool.h"
+#include "hashcache.h"
+
+/*
+ * A hashing thread, which takes one job of the pool after another. Small
+ * regular files are read completely and hashed in batches, large ones
+ * have their TTH split among idle threads.
+ */
+
+struct hasher;
+
+struct hasher *hasher_new(const struct options *opt, struct pool *pool,
+    unsigned jobs, bool mmap);
+void hasher_free(struct hasher *h);
+int hasher_sums(struct hasher *h, int fd, const char *filename,
+    struct tth *tth, struct sha1 *sha1, struct tiger_hash *tiger);
+char *hasher_thex(const struct hasher *h);
+void hash_pool(struct pool *pool, const struct options *opt,
+    struct hashcache *cache);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* HASHER_HEADER_FILE */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "kernel.h"
+#include "cpu.h"
+#include "tiger.h"
+#include "compat_sha1.h"
+
+struct kernel_choice {
+  const char *algo;
+  const struct kernel *kernels;
+  size_t n;
+  const struct kernel *selected;
+};
+
+static struct kernel_choice kernel_choices[4];
+
+/**
+ * Looks up the kernel pinned for "algo" in the environment.
+ *
+ * @return true if a kernel is pinned; its name is copied to "buf".
+ */
+static bool
+kernel_pinned(const char *algo, char *buf, size_t size)
+{
+  size_t algo_len = strlen(algo);
+  const char *s;
+
+  for (s = getenv(KERNEL_ENV); s && '\0' != *s; /* NOTHING */) {
+    const char *end = strchr(s, ',');
+    size_t len = end ? (size_t) (end - s) : strlen(s);
+
+    if (
+      len > algo_len &&
+      '=' == s[algo_len] &&
+      0 == strncmp(s, algo, algo_len)
+    ) {
+      len = MIN(len - algo_len - 1, size - 1);
+      memcpy(buf, &s[algo_len + 1], len);
+      buf[len] = '\0';
+      return true;
+    }
+    s = end ? &end[1] : NULL;
+  }
+  return false;
+}
+
+static void
+kernel_record(const char *algo, const struct kernel *kernels, size_t n,
+  const struct kernel *selected)
+{
+  unsigned i;
+
+  for (i = 0; i < ARRAY_LEN(kernel_choices); i++) {
+    struct kernel_choice *kc = &kernel_choices[i];
+
+    if (NULL == kc->algo || 0 == strcmp(algo, kc->algo)) {
+      kc->algo = algo;
+      kc->kernels = kernels;
+      kc->n = n;
+      kc->selected = selected;
+      return;
+    }
+  }
+  RUNTIME_ASSERT(0);
+}
+
+/**
+ * Selects the kernel to use for the algorithm "algo". Unless a kernel is
+ * pinned through the environment, this is the first kernel of the list
+ * which is supported by the CPU.
+ *
+ * @return the selected kernel.
+ */
+const struct kernel *
+kernel_select(const char *algo, const struct kernel *kernels, size_t n)
+{
+  const struct kernel *selected = NULL;
+  char name[32];
+  size_t i;
+
+  RUNTIME_ASSERT(n > 0);
+  RUNTIME_ASSERT(0 == kernels[n - 1].cpu);
+
+  if (kernel_pinned(algo, name, sizeof name)) {
+    for (i = 0; i < n; i++) {
+      if (0 == strcmp(name, kernels[i].name))
+        break;
+    }
+    if (i == n) {
+      fprintf(stderr, "%s: Unknown %s kernel \"%s\"\n",
+        KERNEL_ENV, algo, name);
+    } else if (!cpu_supports(kernels[i].cpu)) {
+      fprintf(stderr,
+        "%s: The %s kernel \"%s\" is not supported by this CPU\n",
+        KERNEL_ENV, algo, name);
+    } else {
+      selected = &kernels[i];
+    }
+  }
+
+  for (i = 0; NULL == selected; i++) {
+    if (cpu_supports(kernels[i].cpu)) {
+      selected = &kernels[i];
+    }
+  }
+
+  kernel_record(algo, kernels, n, selected);
+  return selected;
+}
+
+#ifndef HAVE_BUILTIN_SHA1
+/* The SHA-1 of the system library is the only choice */
+static void
+sha1_kernel_init(void)
+{
+  static const struct kernel sha1_kernels[] = {
+    { COMPAT_SHA1_NAME, 0, NULL },
+  };
+
+  (void) kernel_select("sha1", sha1_kernels, ARRAY_LEN(sha1_kernels));
+}
+#endif /* !HAVE_BUILTIN_SHA1 */
+
+/**
+ * Selects the kernels of all hash primitives. This should be called once
+ * at startup before any hashing is done.
+ */
+void
+kernels_init(void)
+{
+  tiger_kernel_init();
+  sha1_kernel_init();
+}
+
+/**
+ * Prints the CPU features and the selected kernel of each algorithm
+ * followed by the list of all kernels supported by this CPU.
+ */
+void
+kernels_report(FILE *f)
+{
+  unsigned i;
+
+  fputs("cpu: ", f);
+  cpu_print_features(f);
+
+  for (i = 0; i < ARRAY_LEN(kernel_choices); i++) {
+    const struct kernel_choice *kc = &kernel_choices[i];
+    size_t j;
+
+    if (NULL == kc->algo)
+      break;
+
+    fprintf(f, "%s: %s (supported:", kc->algo, kc->selected->name);
+    for (j = 0; j < kc->n; j++) {
+      if (cpu_supports(kc->kernels[j].cpu)) {
+        fprintf(f, " %s", kc->kernels[j].name);
+      }
+    }
+    fputs(")\n", f);
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
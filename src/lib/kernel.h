@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef KERNEL_HEADER_FILE
+#define KERNEL_HEADER_FILE
+
+#include "common.h"
+
+/* Environment variable to pin kernels, e.g. "tiger=scalar,sha1=openssl" */
+#define KERNEL_ENV "BITTER_KERNELS"
+
+/*
+ * A kernel is one implementation of a hash primitive. Each algorithm
+ * passes its kernels to kernel_select() ordered from fastest to slowest.
+ * The last entry must not require any CPU features.
+ */
+struct kernel {
+  const char *name;       /* as used in KERNEL_ENV and the report */
+  unsigned cpu;           /* required CPU features, see cpu.h */
+  const void *data;       /* implementation specific */
+};
+
+const struct kernel *kernel_select(const char *algo,
+    const struct kernel *kernels, size_t n);
+void kernels_init(void);
+void kernels_report(FILE *f);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* KERNEL_HEADER_FILE */
@@ -2059,6 +2059,42 @@ tokenline(FILE *f, char *buf, size_t size)
   return count;
 }
 
+/**
+ * Reads the next record from "f" up to "delim", which is consumed but not
+ * stored, or the end of the input. Unlike tokenline() the record is taken
+ * as is, so it may contain spaces. A record which does not fit into "buf"
+ * is truncated and the rest of it is discarded.
+ *
+ * @return the length of the record, "size" if it was truncated, or -1 if
+ * there are no more records or reading failed, see ferror().
+ */
+ssize_t
+delimline(FILE *f, char *buf, size_t size, int delim)
+{
+  size_t len = 0;
+  bool truncated = false;
+  int c;
+
+  RUNTIME_ASSERT((ssize_t) size > 0);
+  RUNTIME_ASSERT(buf);
+
+  c = getc(f);
+  if (EOF == c)
+    return -1;
+
+  while (EOF != c && delim != c) {
+    if (len < size - 1) {
+      buf[len++] = c;
+    } else {
+      truncated = true;
+    }
+    c = getc(f);
+  }
+  buf[len] = '\0';
+
+  return truncated ? (ssize_t) size : (ssize_t) len;
+}
+
 static inline FILE *FAILURE(int e) { errno = e; return NULL; }
 
 /* Opens only regular files i.e., doesn't follow sym-links.
@@ -142,6 +142,7 @@ bool cmp_str(const char *a, const char *b);
 int uri_canonize_path(char *dst, const char *path);
 const char *humanize_value(uint64_t v, uint64_t *i, uint64_t *f);
 int tokenline(FILE *f, char *buf, size_t size);
+ssize_t delimline(FILE *f, char *buf, size_t size, int delim);
 char *create_pathname(const char *path, const char *filename);
 FILE *safer_fopen(const char *pathname, safer_fopen_mode_t m);
 uint32_t prime_up(uint32_t n);
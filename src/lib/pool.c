@@ -0,0 +1,759 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "pool.h"
+#include "check.h"
+#include "nettools.h"
+#include "walk.h"
+
+/*
+ * The threads read directories rather than hash files until QUEUE_FILES
+ * files are waiting.
+ */
+#define QUEUE_FILES     1024
+
+/*
+ * With --files-from, at most JOBS_PENDING files are held at a time, read
+ * in groups of LIST_GROUP, so memory does not grow with the list.
+ */
+#define JOBS_PENDING    (16 * 1024)
+#define LIST_GROUP      64
+
+/*
+ * The jobs are handed out to the threads in order. Unless the output is
+ * unordered, each result is printed as soon as all jobs before it are
+ * finished as well. A job is freed once it is no longer needed for that.
+ *
+ * A directory is replaced by its entries in the output order as it is
+ * being read, so the output of the recursive mode does not depend on
+ * how many threads read the directories.
+ *
+ * Once all jobs are handed out, the threads which run out of work steal
+ * subtrees of the TTH of the large files still being hashed, see
+ * tt_parallel_steal().
+ */
+struct pool {
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_t lock;
+  pthread_cond_t cond;          /* signaled on new jobs, splits and results */
+#endif /* HAVE_PTHREAD_SUPPORT */
+  const struct options *opt;
+  pool_print_cb print;          /* prints the results */
+  struct job *head, **tail;     /* jobs in the output order; under lock */
+  struct job *files, **files_tail; /* files to hand out; under lock */
+  struct job *dirs, **dirs_tail;   /* directories to hand out; under lock */
+  size_t queued;                /* files to hand out; under lock */
+  size_t running;               /* jobs handed out, not done; under lock */
+  bool failed;                  /* a job has failed; under lock */
+  unsigned workers;             /* number of threads */
+  struct tt_parallel *split[JOBS_MAX]; /* files to steal from; under lock */
+  unsigned splits;
+  struct inode_set *inodes;     /* hard links and directories; under lock */
+  struct job *free_jobs;        /* jobs for reuse; under lock */
+  struct job *shared;           /* printed first links; under lock */
+  size_t pending;               /* jobs not freed; under lock */
+  FILE *list;                   /* --files-from, NULL at its end */
+  bool listing;                 /* a thread reads the list; under lock */
+  uint64_t line;                /* number of the last line read; ditto */
+  char path[PATH_MAX + 128];    /* read from the list, with a URN; ditto */
+  uint64_t checked_ok, checked_failed, checked_missing; /* under lock */
+};
+
+static inline void
+pool_lock(struct pool *p)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_lock(&p->lock);
+#else
+  (void) p;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+static inline void
+pool_unlock(struct pool *p)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_unlock(&p->lock);
+#else
+  (void) p;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+static inline void
+pool_signal(struct pool *p)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_cond_broadcast(&p->cond);
+#else
+  (void) p;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+static inline void
+pool_wait(struct pool *p)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_cond_wait(&p->cond, &p->lock);
+#else
+  (void) p;
+  RUNTIME_ASSERT(0); /* there is nobody to wait for */
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+/**
+ * Creates an empty pool for a run with "workers" hashing threads, which
+ * prints the results with "print".
+ *
+ * @return NULL on failure with errno set.
+ */
+struct pool *
+pool_new(const struct options *opt, unsigned workers, pool_print_cb print)
+{
+  struct pool *p;
+
+  p = calloc(1, sizeof *p);
+  if (!p)
+    return NULL;
+
+  p->inodes = inode_set_new();
+  if (!p->inodes) {
+    free(p);
+    errno = ENOMEM;
+    return NULL;
+  }
+  p->opt = opt;
+  p->print = print;
+  p->workers = workers;
+  p->tail = &p->head;
+  p->files_tail = &p->files;
+  p->dirs_tail = &p->dirs;
+
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_init(&p->lock, NULL);
+  pthread_cond_init(&p->cond, NULL);
+#endif /* HAVE_PTHREAD_SUPPORT */
+  return p;
+}
+
+/**
+ * Frees the pool once all of its jobs are done.
+ */
+void
+pool_free(struct pool *p)
+{
+  if (p) {
+    RUNTIME_ASSERT(!p->head);
+
+    while (p->free_jobs) {
+      struct job *job = p->free_jobs;
+
+      p->free_jobs = job->next;
+      free(job);
+    }
+    while (p->shared) {
+      struct job *job = p->shared;
+
+      p->shared = job->next;
+      if (job->filename != job->name) {
+        free(job->filename);
+      }
+      free(job->thex);
+      free(job);
+    }
+    if (p->list && stdin != p->list) {
+      fclose(p->list);
+    }
+    inode_set_free(p->inodes);
+#ifdef HAVE_PTHREAD_SUPPORT
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->cond);
+#endif /* HAVE_PTHREAD_SUPPORT */
+    free(p);
+  }
+}
+
+/**
+ * Reads the jobs from the list "path", or the standard input for "-", as
+ * the threads ask for them. With opt->check, each line is a result to
+ * check, otherwise a file to hash.
+ *
+ * @return 0 on success, -1 on failure with errno set.
+ */
+int
+pool_list(struct pool *p, const char *path)
+{
+  if (0 == strcmp(path, "-")) {
+    p->list = stdin;
+  } else {
+    p->list = safer_fopen(path, SAFER_FOPEN_RD);
+    if (!p->list)
+      return -1;
+  }
+  return 0;
+}
+
+unsigned
+pool_workers(const struct pool *p)
+{
+  return p->workers;
+}
+
+/**
+ * @return true if any job has failed.
+ */
+bool
+pool_failed(struct pool *p)
+{
+  bool failed;
+
+  pool_lock(p);
+  failed = p->failed;
+  pool_unlock(p);
+  return failed;
+}
+
+/**
+ * Gets the number of files checked with opt->check by their outcome.
+ */
+void
+pool_checked(struct pool *p, uint64_t *ok, uint64_t *failed,
+    uint64_t *missing)
+{
+  pool_lock(p);
+  *ok = p->checked_ok;
+  *failed = p->checked_failed;
+  *missing = p->checked_missing;
+  pool_unlock(p);
+}
+
+/**
+ * Offers the subtrees of "tp" to the threads which are out of work.
+ */
+void
+pool_split_add(struct pool *p, struct tt_parallel *tp)
+{
+  pool_lock(p);
+  RUNTIME_ASSERT(p->splits < ARRAY_LEN(p->split));
+  p->split[p->splits++] = tp;
+  pool_signal(p);
+  pool_unlock(p);
+}
+
+void
+pool_split_remove(struct pool *p, struct tt_parallel *tp)
+{
+  unsigned i;
+
+  pool_lock(p);
+  for (i = 0; i < p->splits; i++) {
+    if (tp == p->split[i]) {
+      p->split[i] = p->split[--p->splits];
+      break;
+    }
+  }
+  pool_unlock(p);
+}
+
+/**
+ * Gets a job for the file or directory "name" in the directory "dir",
+ * which may be NULL. The jobs which have been printed are reused, and
+ * only a filename too long for the job itself is allocated separately.
+ */
+struct job *
+job_new(struct pool *p, const char *dir, const char *name, bool is_dir)
+{
+  size_t dir_len = dir ? strlen(dir) : 0, name_len = strlen(name);
+  struct job *job;
+  char *filename;
+
+  pool_lock(p);
+  job = p->free_jobs;
+  if (job) {
+    p->free_jobs = job->next;
+  }
+  p->pending++;
+  pool_unlock(p);
+
+  if (!job) {
+    job = malloc(sizeof *job);
+    if (!job) {
+      print_error("malloc", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
+  job->next = NULL;
+  job->queue = NULL;
+  job->dir = is_dir;
+  job->missing = false;
+  job->thex = NULL;
+  job->origin = NULL;
+  job->waiting = NULL;
+  job->shared = false;
+  job->state = JOB_QUEUED;
+  job->digests = (p->opt->sha1 ? DIGEST_SHA1 : 0) |
+    (p->opt->tth ? DIGEST_TTH : 0) | (p->opt->tiger ? DIGEST_TIGER : 0);
+
+  job->filename = job->name;
+  if (dir_len + 1 + name_len + 1 > sizeof job->name) {
+    job->filename = malloc(dir_len + 1 + name_len + 1);
+    if (!job->filename) {
+      print_error("malloc", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  filename = job->filename;
+  if (dir_len > 0) {
+    memcpy(filename, dir, dir_len);
+    filename += dir_len;
+    if ('/' != dir[dir_len - 1]) {
+      *filename++ = '/';
+    }
+  }
+  memcpy(filename, name, name_len + 1);
+  return job;
+}
+
+/*
+ * Puts "job" aside for reuse; called with the lock held. The first link
+ * of a file is kept until the end since more links may turn up.
+ */
+static void
+job_free(struct pool *p, struct job *job)
+{
+  if (job->shared) {
+    job->next = p->shared;
+    p->shared = job;
+    p->pending--;
+    return;
+  }
+  if (job->filename != job->name) {
+    free(job->filename);
+  }
+  free(job->thex);
+  job->next = p->free_jobs;
+  p->free_jobs = job;
+  p->pending--;
+}
+
+/* queues "job" to be handed out; called with the lock held */
+static void
+pool_enqueue(struct pool *p, struct job *job)
+{
+  if (job->dir) {
+    *p->dirs_tail = job;
+    p->dirs_tail = &job->queue;
+  } else {
+    *p->files_tail = job;
+    p->files_tail = &job->queue;
+    p->queued++;
+  }
+}
+
+static void
+pool_add(struct pool *p, struct job *job)
+{
+  pool_lock(p);
+  *p->tail = job;
+  p->tail = &job->next;
+  pool_enqueue(p, job);
+  pool_signal(p);
+  pool_unlock(p);
+}
+
+/**
+ * Inserts the jobs from "first" up to the one whose "next" is "*last"
+ * behind "at" in the output order and queues them.
+ *
+ * @return the last job inserted.
+ */
+struct job *
+pool_insert(struct pool *p, struct job *at, struct job *first,
+    struct job **last)
+{
+  struct job *job, *end;
+
+  pool_lock(p);
+  end = at->next;
+  *last = end;
+  if (!end) {
+    p->tail = last;
+  }
+  at->next = first;
+  for (job = first; job != end; job = job->next) {
+    pool_enqueue(p, job);
+    at = job;
+  }
+  pool_signal(p);
+  pool_unlock(p);
+  return at;
+}
+
+/**
+ * @return true if the inode has been seen before.
+ */
+bool
+pool_seen(struct pool *p, uint64_t dev, uint64_t ino)
+{
+  void *seen;
+
+  pool_lock(p);
+  seen = inode_set_add(p->inodes, dev, ino, p);
+  pool_unlock(p);
+  return NULL != seen;
+}
+
+/**
+ * Records "job" as a link of the file with the inode "ino" on "dev". If
+ * it is not the first link, it takes the results of the first instead of
+ * being hashed.
+ */
+void
+pool_link(struct pool *p, struct job *job, uint64_t dev, uint64_t ino)
+{
+  pool_lock(p);
+  job->origin = inode_set_add(p->inodes, dev, ino, job);
+  if (!job->origin) {
+    job->shared = true;
+  }
+  pool_unlock(p);
+}
+
+/**
+ * Adds a file given on the command line or in the list. In the recursive
+ * mode, it may be a directory.
+ */
+void
+pool_add_path(struct pool *p, const char *path)
+{
+  struct stat sb;
+  struct job *job;
+  bool is_dir = false, linked = false;
+
+  /* Symbolic links given as arguments are always followed */
+  if (p->opt->recursive && 0 == stat(path, &sb)) {
+    linked = S_ISREG(sb.st_mode) && sb.st_nlink > 1;
+    is_dir = S_ISDIR(sb.st_mode);
+  }
+  job = job_new(p, NULL, path, is_dir);
+  if (linked) {
+    pool_link(p, job, sb.st_dev, sb.st_ino);
+  }
+  pool_add(p, job);
+}
+
+static void
+pool_fail(struct pool *p)
+{
+  pool_lock(p);
+  p->failed = true;
+  pool_unlock(p);
+}
+
+/**
+ * Adds a job to check the result line "line" of "len" bytes.
+ */
+static void
+check_add(struct pool *p, char *line, size_t len)
+{
+  unsigned digests;
+  struct sha1 sha1;
+  struct tth tth;
+  struct tiger_hash tiger;
+  struct job *job;
+
+  digests = check_parse(line, len, &sha1, &tth, &tiger);
+  if (0 == digests) {
+    fprintf(stderr, "%s:%" PRIu64 ": Improperly formatted line\n",
+      p->opt->check, p->line);
+    pool_fail(p);
+    return;
+  }
+
+  job = job_new(p, NULL, line, false);
+  job->digests = digests;
+  job->expected.sha1 = sha1;
+  job->expected.tth = tth;
+  job->expected.tiger = tiger;
+  pool_add(p, job);
+}
+
+/**
+ * Compares the digests of a file with the expected ones and counts the
+ * result; must be called under lock.
+ *
+ * @return true if the file was hashed and all digests match.
+ */
+static bool
+check_done(struct pool *p, const struct job *job, bool ok)
+{
+  if (
+    ok &&
+    (
+      ((job->digests & DIGEST_SHA1) &&
+       0 != memcmp(&job->sha1, &job->expected.sha1, sizeof job->sha1)) ||
+      ((job->digests & DIGEST_TTH) &&
+       0 != memcmp(&job->tth, &job->expected.tth, sizeof job->tth)) ||
+      ((job->digests & DIGEST_TIGER) &&
+       0 != memcmp(&job->tiger, &job->expected.tiger, sizeof job->tiger))
+    )
+  ) {
+    ok = false;
+  }
+
+  if (ok) {
+    p->checked_ok++;
+  } else if (job->missing) {
+    p->checked_missing++;
+  } else {
+    p->checked_failed++;
+  }
+  return ok;
+}
+
+/**
+ * Reads up to LIST_GROUP files from the list; only one thread at a time
+ * may do so. Empty entries are skipped.
+ *
+ * @return false at the end of the list.
+ */
+static bool
+pool_read_list(struct pool *p)
+{
+  unsigned i;
+
+  for (i = 0; i < LIST_GROUP; i++) {
+    ssize_t len;
+
+    len = delimline(p->list, p->path, sizeof p->path, p->opt->delim);
+    if (len < 0) {
+      if (ferror(p->list)) {
+        print_error("read",
+          p->opt->check ? p->opt->check : p->opt->files_from, errno);
+        pool_fail(p);
+      }
+      return false;
+    }
+    p->line++;
+    if ((size_t) len >= sizeof p->path) {
+      print_error("read", p->path, ENAMETOOLONG);
+      pool_fail(p);
+    } else if (len > 0) {
+      if (p->opt->check) {
+        check_add(p, p->path, len);
+      } else {
+        pool_add_path(p, p->path);
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Takes a subtree from one of the large files being hashed, see
+ * tt_parallel_steal(). Called with the lock held.
+ */
+static struct tt_parallel *
+pool_steal(struct pool *p, size_t *i)
+{
+  unsigned j;
+
+  for (j = 0; j < p->splits; j++) {
+    if (tt_parallel_steal(p->split[j], i))
+      return p->split[j];
+  }
+  return NULL;
+}
+
+/**
+ * Records the outcome of "job" and prints whatever results are due;
+ * called with the lock held.
+ */
+static void
+job_done(struct pool *p, struct job *job, bool ok)
+{
+  if (p->opt->check && !job->dir) {
+    ok = check_done(p, job, ok);
+  }
+  job->state = ok ? JOB_DONE : JOB_FAILED;
+  if (!ok) {
+    p->failed = true;
+  }
+
+  /* With --check, failures are printed as well */
+  if (p->opt->unordered && (ok || p->opt->check) && !job->dir) {
+    p->print(p->opt, job);
+  }
+  while (p->head && JOB_QUEUED != p->head->state) {
+    struct job *next = p->head->next;
+
+    if (
+      !p->opt->unordered && !p->head->dir &&
+      (JOB_DONE == p->head->state || p->opt->check)
+    ) {
+      p->print(p->opt, p->head);
+    }
+    job_free(p, p->head);
+    p->head = next;
+  }
+  if (!p->head) {
+    p->tail = &p->head;
+  }
+}
+
+/**
+ * Gives the link "job" the results of the first link of the file, which
+ * is done; called with the lock held.
+ */
+static void
+job_follow(struct pool *p, struct job *job)
+{
+  const struct job *origin = job->origin;
+
+  job->sha1 = origin->sha1;
+  job->tth = origin->tth;
+  job->tiger = origin->tiger;
+  if (origin->thex) {
+    job->thex = strdup(origin->thex);
+    if (!job->thex) {
+      print_error("malloc", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
+  job_done(p, job, JOB_DONE == origin->state);
+}
+
+/**
+ * Hands out the next job, preferring directories as long as there are
+ * not many files waiting. With "wait", a thread without a job helps with
+ * the large files of the others and waits for the directories being read
+ * to yield more jobs.
+ *
+ * @return the next job or NULL if there are none left.
+ */
+struct job *
+pool_next(struct pool *p, bool wait)
+{
+  struct job *job = NULL;
+
+  pool_lock(p);
+  for (;;) {
+    struct tt_parallel *tp;
+    size_t i;
+
+    if (
+      p->list && !p->listing &&
+      p->queued < QUEUE_FILES && p->pending < JOBS_PENDING
+    ) {
+      bool more;
+
+      p->listing = true;
+      pool_unlock(p);
+      more = pool_read_list(p);
+      pool_lock(p);
+      p->listing = false;
+      if (!more) {
+        if (stdin != p->list) {
+          fclose(p->list);
+        }
+        p->list = NULL;
+      }
+      pool_signal(p);
+    }
+
+    if (p->dirs && (p->queued < QUEUE_FILES || !p->files)) {
+      job = p->dirs;
+      p->dirs = job->queue;
+      if (!p->dirs) {
+        p->dirs_tail = &p->dirs;
+      }
+    } else if (p->files) {
+      job = p->files;
+      p->files = job->queue;
+      if (!p->files) {
+        p->files_tail = &p->files;
+      }
+      p->queued--;
+
+      /* The other links of a file take the results of the first */
+      if (job->origin) {
+        if (JOB_QUEUED == job->origin->state) {
+          job->queue = job->origin->waiting;
+          job->origin->waiting = job;
+        } else {
+          job_follow(p, job);
+        }
+        job = NULL;
+        continue;
+      }
+    }
+    if (job) {
+      p->running++;
+      break;
+    }
+    if (!wait || (0 == p->running && !p->list && !p->listing))
+      break;
+
+    tp = pool_steal(p, &i);
+    if (tp) {
+      /* tt_parallel_finish() waits for it, so "tp" stays valid */
+      pool_unlock(p);
+      tt_parallel_stolen(tp, i);
+      pool_lock(p);
+    } else {
+      pool_wait(p);
+    }
+  }
+  pool_unlock(p);
+  return job;
+}
+
+/**
+ * Records the outcome of a job and of the other links waiting for it,
+ * and prints whatever results are due.
+ */
+void
+pool_done(struct pool *p, struct job *job, bool ok)
+{
+  struct job *link;
+
+  pool_lock(p);
+  p->running--;
+  pool_signal(p);
+  link = job->waiting;
+  job->waiting = NULL;
+  job_done(p, job, ok);
+  while (link) {
+    struct job *next = link->queue;
+
+    job_follow(p, link);
+    link = next;
+  }
+  pool_unlock(p);
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef POOL_HEADER_FILE
+#define POOL_HEADER_FILE
+
+#include "digest.h"
+#include "tt_parallel.h"
+
+/*
+ * The jobs of a run: the files to hash and, in the recursive mode, the
+ * directories to read, which are handed out to the hashing threads. See
+ * struct pool in pool.c.
+ */
+
+#define JOBS_MAX 256
+
+/*
+ * The settings of a run, shared by all threads.
+ */
+struct options {
+  bool get_bitprint, quiet, tth, sha1, tiger, nocache, unordered;
+  bool recursive, follow;
+  bool xattr;                   /* cache the digests in "user.bitprint" */
+  const char *cache;            /* cache database or NULL */
+  const char *check;            /* list of results to verify or NULL */
+  const char *files_from;       /* list of files, "-" for stdin, or NULL */
+  int delim;                    /* separator of the list */
+  unsigned jobs;                /* threads in total */
+  unsigned depth;               /* io_uring queue depth, 0 for none */
+  unsigned thex;                /* levels of the THEX tree, 0 for none */
+  const char *tree;             /* THEX tree to verify a file with or NULL */
+  bool stop;                    /* stop verifying at a corrupt segment */
+  bool range;                   /* only verify the bytes "from" to "to" */
+  uint64_t from, to;
+};
+
+/*
+ * A file to hash or, in the recursive mode, a directory to read. The
+ * results are kept until they can be printed. With --check, the expected
+ * digests are kept as well. Of the links of a file, only the first is
+ * hashed and the others take its results.
+ */
+struct job {
+  struct job *next;             /* in the order of the output */
+  struct job *queue;            /* next job to hand out */
+  char *filename;               /* "name" or allocated if too long */
+  unsigned digests;             /* enum digest */
+  struct sha1 sha1;
+  struct tth tth;
+  struct tiger_hash tiger;
+  struct {
+    struct sha1 sha1;
+    struct tth tth;
+    struct tiger_hash tiger;
+  } expected;
+  char *thex;                   /* "DEPTH:BASE32" of the tree or NULL */
+  struct job *origin;           /* the first link of the file or NULL */
+  struct job *waiting;          /* links waiting for the results */
+  bool dir;                     /* a directory, nothing to print */
+  bool shared;                  /* kept for the other links */
+  bool missing;                 /* the file does not exist */
+  enum job_state {
+    JOB_QUEUED,
+    JOB_DONE,
+    JOB_FAILED
+  } state;
+  char name[128];
+};
+
+static inline struct sha1 *
+job_sha1(struct job *job)
+{
+  return (job->digests & DIGEST_SHA1) ? &job->sha1 : NULL;
+}
+
+static inline struct tth *
+job_tth(struct job *job)
+{
+  return (job->digests & DIGEST_TTH) ? &job->tth : NULL;
+}
+
+static inline struct tiger_hash *
+job_tiger(struct job *job)
+{
+  return (job->digests & DIGEST_TIGER) ? &job->tiger : NULL;
+}
+
+/* prints the result of "job"; called with the lock of the pool held */
+typedef void (*pool_print_cb)(const struct options *opt,
+    const struct job *job);
+
+struct pool;
+
+struct pool *pool_new(const struct options *opt, unsigned workers,
+    pool_print_cb print);
+void pool_free(struct pool *p);
+int pool_list(struct pool *p, const char *path);
+unsigned pool_workers(const struct pool *p);
+bool pool_failed(struct pool *p);
+void pool_checked(struct pool *p, uint64_t *ok, uint64_t *failed,
+    uint64_t *missing);
+struct job *job_new(struct pool *p, const char *dir, const char *name,
+    bool is_dir);
+void pool_add_path(struct pool *p, const char *path);
+struct job *pool_insert(struct pool *p, struct job *at, struct job *first,
+    struct job **last);
+bool pool_seen(struct pool *p, uint64_t dev, uint64_t ino);
+void pool_link(struct pool *p, struct job *job, uint64_t dev, uint64_t ino);
+struct job *pool_next(struct pool *p, bool wait);
+void pool_done(struct pool *p, struct job *job, bool ok);
+void pool_split_add(struct pool *p, struct tt_parallel *tp);
+void pool_split_remove(struct pool *p, struct tt_parallel *tp);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* POOL_HEADER_FILE */
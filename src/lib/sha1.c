@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * SHA-1 as specified in FIPS 180-4. The compression function is chosen
+ * at run time, see sha1_kernel_init().
+ */
+
+#include "sha1.h"
+#include "sha1_simd.h"
+#include "kernel.h"
+#include "cpu.h"
+#include "compat.h"
+
+static void
+sha1_compress_scalar(uint32_t state[5], const uint8_t *data, size_t blocks)
+{
+  for (/* NOTHING */; blocks > 0; blocks--) {
+    uint32_t a, b, c, d, e, w[16];
+    unsigned t;
+
+    for (t = 0; t < 16; t++) {
+      w[t] = peek_be32(&data[t * 4]);
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+
+    /* Five rounds per iteration rename the variables back */
+    for (t = 0; t < 15; t += 5) {
+      SHA1_ROUND(a, b, c, d, e, SHA1_F0, SHA1_K0, w[t])
+      SHA1_ROUND(e, a, b, c, d, SHA1_F0, SHA1_K0, w[t + 1])
+      SHA1_ROUND(d, e, a, b, c, SHA1_F0, SHA1_K0, w[t + 2])
+      SHA1_ROUND(c, d, e, a, b, SHA1_F0, SHA1_K0, w[t + 3])
+      SHA1_ROUND(b, c, d, e, a, SHA1_F0, SHA1_K0, w[t + 4])
+    }
+    SHA1_ROUND(a, b, c, d, e, SHA1_F0, SHA1_K0, w[15])
+    SHA1_ROUND(e, a, b, c, d, SHA1_F0, SHA1_K0, SHA1_W(w, 16))
+    SHA1_ROUND(d, e, a, b, c, SHA1_F0, SHA1_K0, SHA1_W(w, 17))
+    SHA1_ROUND(c, d, e, a, b, SHA1_F0, SHA1_K0, SHA1_W(w, 18))
+    SHA1_ROUND(b, c, d, e, a, SHA1_F0, SHA1_K0, SHA1_W(w, 19))
+
+    for (t = 20; t < 40; t += 5) {
+      SHA1_ROUND(a, b, c, d, e, SHA1_F1, SHA1_K1, SHA1_W(w, t))
+      SHA1_ROUND(e, a, b, c, d, SHA1_F1, SHA1_K1, SHA1_W(w, t + 1))
+      SHA1_ROUND(d, e, a, b, c, SHA1_F1, SHA1_K1, SHA1_W(w, t + 2))
+      SHA1_ROUND(c, d, e, a, b, SHA1_F1, SHA1_K1, SHA1_W(w, t + 3))
+      SHA1_ROUND(b, c, d, e, a, SHA1_F1, SHA1_K1, SHA1_W(w, t + 4))
+    }
+    for (t = 40; t < 60; t += 5) {
+      SHA1_ROUND(a, b, c, d, e, SHA1_F2, SHA1_K2, SHA1_W(w, t))
+      SHA1_ROUND(e, a, b, c, d, SHA1_F2, SHA1_K2, SHA1_W(w, t + 1))
+      SHA1_ROUND(d, e, a, b, c, SHA1_F2, SHA1_K2, SHA1_W(w, t + 2))
+      SHA1_ROUND(c, d, e, a, b, SHA1_F2, SHA1_K2, SHA1_W(w, t + 3))
+      SHA1_ROUND(b, c, d, e, a, SHA1_F2, SHA1_K2, SHA1_W(w, t + 4))
+    }
+    for (t = 60; t < 80; t += 5) {
+      SHA1_ROUND(a, b, c, d, e, SHA1_F3, SHA1_K3, SHA1_W(w, t))
+      SHA1_ROUND(e, a, b, c, d, SHA1_F3, SHA1_K3, SHA1_W(w, t + 1))
+      SHA1_ROUND(d, e, a, b, c, SHA1_F3, SHA1_K3, SHA1_W(w, t + 2))
+      SHA1_ROUND(c, d, e, a, b, SHA1_F3, SHA1_K3, SHA1_W(w, t + 3))
+      SHA1_ROUND(b, c, d, e, a, SHA1_F3, SHA1_K3, SHA1_W(w, t + 4))
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    data += 64;
+  }
+}
+
+struct sha1_kernel {
+  sha1_compress_t compress;
+};
+
+#if defined(HAVE_SHA_INTRINSICS)
+static const struct sha1_kernel sha1_kernel_shani = { sha1_compress_shani };
+#endif /* HAVE_SHA_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+static const struct sha1_kernel sha1_kernel_avx2 = { sha1_compress_avx2 };
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_SSSE3_INTRINSICS)
+static const struct sha1_kernel sha1_kernel_ssse3 = { sha1_compress_ssse3 };
+#endif /* HAVE_SSSE3_INTRINSICS */
+
+static const struct sha1_kernel sha1_kernel_scalar = { sha1_compress_scalar };
+
+/* Ordered from fastest to slowest */
+static const struct kernel sha1_kernels[] = {
+#if defined(HAVE_SHA_INTRINSICS)
+  { "shani",  CPU_SHA | CPU_SSSE3,  &sha1_kernel_shani },
+#endif /* HAVE_SHA_INTRINSICS */
+#if defined(HAVE_AVX2_INTRINSICS)
+  { "avx2",   CPU_AVX2,             &sha1_kernel_avx2 },
+#endif /* HAVE_AVX2_INTRINSICS */
+#if defined(HAVE_SSSE3_INTRINSICS)
+  { "ssse3",  CPU_SSSE3,            &sha1_kernel_ssse3 },
+#endif /* HAVE_SSSE3_INTRINSICS */
+  { "scalar", 0,                    &sha1_kernel_scalar },
+};
+
+struct sha1_multi_kernel {
+  unsigned lanes;
+  sha1_compress_lanes_t compress_lanes;
+};
+
+#if defined(HAVE_AVX512_INTRINSICS)
+static const struct sha1_multi_kernel sha1_multi_kernel_avx512 = {
+  16, sha1_compress_x16_avx512
+};
+#endif /* HAVE_AVX512_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+static const struct sha1_multi_kernel sha1_multi_kernel_avx2 = {
+  8, sha1_compress_x8_avx2
+};
+#endif /* HAVE_AVX2_INTRINSICS */
+
+/* One message after another with the kernel selected for "sha1" */
+static const struct sha1_multi_kernel sha1_multi_kernel_serial = { 1, NULL };
+
+/* Ordered from fastest to slowest */
+static const struct kernel sha1_multi_kernels[] = {
+#if defined(HAVE_AVX512_INTRINSICS)
+  { "avx512", CPU_AVX512F,  &sha1_multi_kernel_avx512 },
+#endif /* HAVE_AVX512_INTRINSICS */
+#if defined(HAVE_AVX2_INTRINSICS)
+  { "avx2",   CPU_AVX2,     &sha1_multi_kernel_avx2 },
+#endif /* HAVE_AVX2_INTRINSICS */
+  { "serial", 0,            &sha1_multi_kernel_serial },
+};
+
+static sha1_compress_t sha1_compress;
+static const struct sha1_multi_kernel *sha1_multi_kernel;
+
+/**
+ * Selects the compression functions of the built-in SHA-1, both for
+ * single messages ("sha1") and for sha1_multi() ("sha1mb").
+ */
+void
+sha1_kernel_init(void)
+{
+  const struct sha1_kernel *k;
+
+  k = kernel_select("sha1", sha1_kernels, ARRAY_LEN(sha1_kernels))->data;
+  sha1_compress = k->compress;
+  sha1_multi_kernel = kernel_select("sha1mb",
+      sha1_multi_kernels, ARRAY_LEN(sha1_multi_kernels))->data;
+}
+
+void
+sha1_init(struct sha1_ctx *ctx)
+{
+  if (NULL == sha1_compress) {
+    sha1_kernel_init();
+  }
+  ctx->state[0] = 0x67452301UL;
+  ctx->state[1] = 0xEFCDAB89UL;
+  ctx->state[2] = 0x98BADCFEUL;
+  ctx->state[3] = 0x10325476UL;
+  ctx->state[4] = 0xC3D2E1F0UL;
+  ctx->length = 0;
+}
+
+void
+sha1_update(struct sha1_ctx *ctx, const void *data, size_t size)
+{
+  const uint8_t *p = data;
+  size_t fill = ctx->length % 64;
+
+  ctx->length += size;
+
+  if (fill > 0) {
+    size_t n = MIN(size, 64 - fill);
+
+    memcpy(&ctx->block[fill], p, n);
+    if (fill + n < 64)
+      return;
+
+    sha1_compress(ctx->state, ctx->block, 1);
+    p += n;
+    size -= n;
+  }
+
+  if (size >= 64) {
+    sha1_compress(ctx->state, p, size / 64);
+    p += size & ~(size_t) 63;
+    size %= 64;
+  }
+  memcpy(ctx->block, p, size);
+}
+
+void
+sha1_final(struct sha1_ctx *ctx, uint8_t digest[20])
+{
+  uint8_t pad[128];
+  size_t rest = ctx->length % 64, size;
+  unsigned i;
+
+  size = rest < 56 ? 64 : 128;
+  memset(pad, 0, size);
+  memcpy(pad, ctx->block, rest);
+  pad[rest] = 0x80;
+  poke_be64(&pad[size - 8], ctx->length << 3);
+  sha1_compress(ctx->state, pad, size / 64);
+
+  for (i = 0; i < 5; i++) {
+    poke_be32(&digest[i * 4], ctx->state[i]);
+  }
+}
+
+/* A message in flight in one lane of sha1_multi() */
+struct sha1_lane {
+  const uint8_t *p;             /* next block */
+  size_t blocks;                /* blocks left at "p" */
+  size_t job;                   /* index of the message */
+  bool padded;                  /* "p" points to "pad" */
+  uint8_t pad[128];             /* tail of the message and padding */
+};
+
+/**
+ * Starts hashing message "job" in "lane". The whole blocks are compressed
+ * straight from the message, the tail is copied into the padding blocks.
+ */
+static void
+sha1_lane_start(struct sha1_lane *lane, uint32_t state[], unsigned lanes,
+  unsigned l, size_t job, const void *data, size_t size)
+{
+  static const uint32_t iv[5] = {
+    0x67452301UL, 0xEFCDAB89UL, 0x98BADCFEUL, 0x10325476UL, 0xC3D2E1F0UL
+  };
+  size_t rest = size % 64, pad_size;
+  unsigned i;
+
+  for (i = 0; i < 5; i++) {
+    state[i * lanes + l] = iv[i];
+  }
+
+  pad_size = rest < 56 ? 64 : 128;
+  memset(lane->pad, 0, pad_size);
+  memcpy(lane->pad, (const uint8_t *) data + (size - rest), rest);
+  lane->pad[rest] = 0x80;
+  poke_be64(&lane->pad[pad_size - 8], (uint64_t) size << 3);
+
+  lane->job = job;
+  lane->p = data;
+  lane->blocks = size / 64;
+  lane->padded = false;
+  if (0 == lane->blocks) {
+    lane->p = lane->pad;
+    lane->blocks = pad_size / 64;
+    lane->padded = true;
+  }
+}
+
+/**
+ * Hashes the messages with "lanes" messages in flight at a time. Whenever
+ * a message in a lane is done, the next one takes its place so that the
+ * lanes stay busy even if the messages differ in length. Idle lanes
+ * hash a copy of a busy lane and their result is discarded.
+ */
+static void
+sha1_multi_lanes(const void * const data[], const size_t size[], size_t n,
+  unsigned lanes, sha1_compress_lanes_t compress_lanes, uint8_t digest[][20])
+{
+  uint32_t state[5 * SHA1_LANES_MAX];
+  struct sha1_lane lane[SHA1_LANES_MAX];
+  const uint8_t *p[SHA1_LANES_MAX];
+  bool busy[SHA1_LANES_MAX];
+  size_t next = 0;
+  unsigned l, active = 0;
+
+  RUNTIME_ASSERT(lanes <= SHA1_LANES_MAX);
+
+  for (l = 0; l < lanes; l++) {
+    busy[l] = next < n;
+    if (busy[l]) {
+      sha1_lane_start(&lane[l], state, lanes, l, next, data[next], size[next]);
+      next++;
+      active++;
+    }
+  }
+
+  while (active > 0) {
+    size_t blocks = (size_t) -1;
+    unsigned any = 0;
+
+    for (l = 0; l < lanes; l++) {
+      if (busy[l]) {
+        blocks = MIN(blocks, lane[l].blocks);
+        any = l;
+      }
+    }
+    for (l = 0; l < lanes; l++) {
+      p[l] = busy[l] ? lane[l].p : lane[any].p;
+    }
+    compress_lanes(p, blocks, state);
+
+    for (l = 0; l < lanes; l++) {
+      struct sha1_lane *ln = &lane[l];
+      unsigned i;
+
+      if (!busy[l])
+        continue;
+
+      ln->p += blocks * 64;
+      ln->blocks -= blocks;
+      if (ln->blocks > 0)
+        continue;
+
+      if (!ln->padded) {
+        ln->blocks = size[ln->job] % 64 < 56 ? 1 : 2;
+        ln->p = ln->pad;
+        ln->padded = true;
+        continue;
+      }
+
+      for (i = 0; i < 5; i++) {
+        poke_be32(&digest[ln->job][i * 4], state[i * lanes + l]);
+      }
+      if (next < n) {
+        sha1_lane_start(ln, state, lanes, l, next, data[next], size[next]);
+        next++;
+      } else {
+        busy[l] = false;
+        active--;
+      }
+    }
+  }
+}
+
+/**
+ * Calculates the SHA-1 of each of the "n" messages data[i] of size[i]
+ * bytes. Depending on the CPU, several messages are hashed at once which
+ * is much faster than hashing many small messages one after another.
+ */
+void
+sha1_multi(const void * const data[], const size_t size[], size_t n,
+  uint8_t digest[][20])
+{
+  size_t i;
+
+  if (NULL == sha1_compress) {
+    sha1_kernel_init();
+  }
+
+  if (sha1_multi_kernel->lanes > 1 && n > 1) {
+    sha1_multi_lanes(data, size, n, sha1_multi_kernel->lanes,
+      sha1_multi_kernel->compress_lanes, digest);
+    return;
+  }
+
+  for (i = 0; i < n; i++) {
+    struct sha1_ctx ctx;
+
+    sha1_init(&ctx);
+    sha1_update(&ctx, data[i], size[i]);
+    sha1_final(&ctx, digest[i]);
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef SHA1_HEADER_FILE
+#define SHA1_HEADER_FILE
+
+#include "common.h"
+
+/* state of a SHA-1 hash calculated piecewise */
+struct sha1_ctx {
+  uint32_t state[5];
+  uint64_t length;              /* message bytes so far */
+  uint8_t block[64];            /* partial block */
+};
+
+/* Compresses "blocks" consecutive 64-byte blocks into "state" */
+typedef void (*sha1_compress_t)(uint32_t state[5], const uint8_t *data,
+    size_t blocks);
+
+/* Like sha1_compress_t for one message per lane, see sha1_simd.h */
+typedef void (*sha1_compress_lanes_t)(const uint8_t * const data[],
+    size_t blocks, uint32_t state[]);
+
+#define SHA1_LANES_MAX 16
+
+void sha1_init(struct sha1_ctx *ctx);
+void sha1_update(struct sha1_ctx *ctx, const void *data, size_t size);
+void sha1_final(struct sha1_ctx *ctx, uint8_t digest[20]);
+void sha1_multi(const void * const data[], const size_t size[], size_t n,
+    uint8_t digest[][20]);
+void sha1_kernel_init(void);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* SHA1_HEADER_FILE */
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "sha1_simd.h"
+
+#if defined(HAVE_SSSE3_INTRINSICS) || defined(HAVE_AVX2_INTRINSICS) || \
+    defined(HAVE_AVX512_INTRINSICS) || defined(HAVE_SHA_INTRINSICS)
+
+#include <immintrin.h>
+
+#endif
+
+#if defined(HAVE_SSSE3_INTRINSICS) || defined(HAVE_AVX2_INTRINSICS)
+
+/*
+ * The 80 rounds of one block; wk[t] is W[t] + K[t]. This must be inlined
+ * so that it is compiled for the instruction set of the caller, otherwise
+ * mixing its SSE code with AVX code is slow.
+ */
+static inline ALWAYS_INLINE void
+sha1_rounds(uint32_t state[5], const uint32_t wk[80])
+{
+  uint32_t a, b, c, d, e;
+  unsigned t;
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+
+  for (t = 0; t < 20; t += 5) {
+    SHA1_ROUND(a, b, c, d, e, SHA1_F0, 0, wk[t])
+    SHA1_ROUND(e, a, b, c, d, SHA1_F0, 0, wk[t + 1])
+    SHA1_ROUND(d, e, a, b, c, SHA1_F0, 0, wk[t + 2])
+    SHA1_ROUND(c, d, e, a, b, SHA1_F0, 0, wk[t + 3])
+    SHA1_ROUND(b, c, d, e, a, SHA1_F0, 0, wk[t + 4])
+  }
+  for (t = 20; t < 40; t += 5) {
+    SHA1_ROUND(a, b, c, d, e, SHA1_F1, 0, wk[t])
+    SHA1_ROUND(e, a, b, c, d, SHA1_F1, 0, wk[t + 1])
+    SHA1_ROUND(d, e, a, b, c, SHA1_F1, 0, wk[t + 2])
+    SHA1_ROUND(c, d, e, a, b, SHA1_F1, 0, wk[t + 3])
+    SHA1_ROUND(b, c, d, e, a, SHA1_F1, 0, wk[t + 4])
+  }
+  for (t = 40; t < 60; t += 5) {
+    SHA1_ROUND(a, b, c, d, e, SHA1_F2, 0, wk[t])
+    SHA1_ROUND(e, a, b, c, d, SHA1_F2, 0, wk[t + 1])
+    SHA1_ROUND(d, e, a, b, c, SHA1_F2, 0, wk[t + 2])
+    SHA1_ROUND(c, d, e, a, b, SHA1_F2, 0, wk[t + 3])
+    SHA1_ROUND(b, c, d, e, a, SHA1_F2, 0, wk[t + 4])
+  }
+  for (t = 60; t < 80; t += 5) {
+    SHA1_ROUND(a, b, c, d, e, SHA1_F3, 0, wk[t])
+    SHA1_ROUND(e, a, b, c, d, SHA1_F3, 0, wk[t + 1])
+    SHA1_ROUND(d, e, a, b, c, SHA1_F3, 0, wk[t + 2])
+    SHA1_ROUND(c, d, e, a, b, SHA1_F3, 0, wk[t + 3])
+    SHA1_ROUND(b, c, d, e, a, SHA1_F3, 0, wk[t + 4])
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+static const uint32_t sha1_k[4] = { SHA1_K0, SHA1_K1, SHA1_K2, SHA1_K3 };
+
+/*
+ * Four words of the schedule at a time:
+ *
+ *   W[t..t+3] = ROL(W[t-16..t-13] ^ W[t-14..t-11] ^ W[t-8..t-5] ^
+ *                   W[t-3..t-1] || 0, 1)
+ *
+ * W[t+3] depends on W[t] which is not known yet, so its term is missing
+ * from the last lane and xor'ed in afterwards as ROL(W[t], 1).
+ */
+#define SHA1_SCHEDULE(w, g) \
+{ \
+  vec x_, r_; \
+\
+  x_ = V_XOR(V_XOR(w[(g) - 4], V_ALIGNR(w[(g) - 3], w[(g) - 4], 8)), \
+             V_XOR(w[(g) - 2], V_SRLI128(w[(g) - 1], 4))); \
+  r_ = V_OR(V_SLLI(x_, 1), V_SRLI(x_, 31)); \
+  x_ = V_SLLI128(r_, 12); \
+  w[(g)] = V_XOR(r_, V_OR(V_SLLI(x_, 1), V_SRLI(x_, 31))); \
+}
+
+#endif /* HAVE_SSSE3_INTRINSICS || HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_SSSE3_INTRINSICS)
+
+#define vec           __m128i
+#define V_XOR(a, b)   _mm_xor_si128((a), (b))
+#define V_OR(a, b)    _mm_or_si128((a), (b))
+#define V_SLLI(a, n)  _mm_slli_epi32((a), (n))
+#define V_SRLI(a, n)  _mm_srli_epi32((a), (n))
+#define V_SLLI128(a, n) _mm_slli_si128((a), (n))
+#define V_SRLI128(a, n) _mm_srli_si128((a), (n))
+#define V_ALIGNR(a, b, n) _mm_alignr_epi8((a), (b), (n))
+
+void __attribute__((__target__("ssse3")))
+sha1_compress_ssse3(uint32_t state[5], const uint8_t *data, size_t blocks)
+{
+  const __m128i bswap =
+    _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+  for (/* NOTHING */; blocks > 0; blocks--) {
+    uint32_t wk[80];
+    __m128i w[20];
+    unsigned g;
+
+    for (g = 0; g < 4; g++) {
+      w[g] = _mm_shuffle_epi8(
+          _mm_loadu_si128((const void *) &data[g * 16]), bswap);
+    }
+    for (g = 4; g < 20; g++) {
+      SHA1_SCHEDULE(w, g)
+    }
+    for (g = 0; g < 20; g++) {
+      _mm_storeu_si128((void *) &wk[g * 4],
+          _mm_add_epi32(w[g], _mm_set1_epi32(sha1_k[g / 5])));
+    }
+    sha1_rounds(state, wk);
+    data += 64;
+  }
+}
+
+#undef vec
+#undef V_XOR
+#undef V_OR
+#undef V_SLLI
+#undef V_SRLI
+#undef V_SLLI128
+#undef V_SRLI128
+#undef V_ALIGNR
+
+#endif /* HAVE_SSSE3_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+
+#define vec           __m256i
+#define V_XOR(a, b)   _mm256_xor_si256((a), (b))
+#define V_OR(a, b)    _mm256_or_si256((a), (b))
+#define V_SLLI(a, n)  _mm256_slli_epi32((a), (n))
+#define V_SRLI(a, n)  _mm256_srli_epi32((a), (n))
+#define V_SLLI128(a, n) _mm256_bslli_epi128((a), (n))
+#define V_SRLI128(a, n) _mm256_bsrli_epi128((a), (n))
+#define V_ALIGNR(a, b, n) _mm256_alignr_epi8((a), (b), (n))
+
+/*
+ * The byte shifts work on each 128-bit half separately, so the upper
+ * half carries the schedule of a second block.
+ */
+static inline void __attribute__((__target__("avx2")))
+sha1_schedule_avx2(const uint8_t *p0, const uint8_t *p1, uint32_t wk[2][80])
+{
+  const __m256i bswap = _mm256_set_epi8(
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  __m256i w[20];
+  unsigned g;
+
+  for (g = 0; g < 4; g++) {
+    __m256i v;
+
+    v = _mm256_castsi128_si256(_mm_loadu_si128((const void *) &p0[g * 16]));
+    v = _mm256_inserti128_si256(v,
+          _mm_loadu_si128((const void *) &p1[g * 16]), 1);
+    w[g] = _mm256_shuffle_epi8(v, bswap);
+  }
+  for (g = 4; g < 20; g++) {
+    SHA1_SCHEDULE(w, g)
+  }
+  for (g = 0; g < 20; g++) {
+    __m256i v = _mm256_add_epi32(w[g], _mm256_set1_epi32(sha1_k[g / 5]));
+
+    _mm_storeu_si128((void *) &wk[0][g * 4], _mm256_castsi256_si128(v));
+    _mm_storeu_si128((void *) &wk[1][g * 4], _mm256_extracti128_si256(v, 1));
+  }
+}
+
+void __attribute__((__target__("avx2")))
+sha1_compress_avx2(uint32_t state[5], const uint8_t *data, size_t blocks)
+{
+  uint32_t wk[2][80];
+
+  for (/* NOTHING */; blocks >= 2; blocks -= 2) {
+    sha1_schedule_avx2(data, &data[64], wk);
+    sha1_rounds(state, wk[0]);
+    sha1_rounds(state, wk[1]);
+    data += 128;
+  }
+  if (blocks > 0) {
+    sha1_schedule_avx2(data, data, wk);
+    sha1_rounds(state, wk[0]);
+  }
+}
+
+#undef vec
+#undef V_XOR
+#undef V_OR
+#undef V_SLLI
+#undef V_SRLI
+#undef V_SLLI128
+#undef V_SRLI128
+#undef V_ALIGNR
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_SHA_INTRINSICS)
+
+/*
+ * Each SHA1RNDS4 does four rounds. Its message input for rounds 4r..4r+3
+ * is the next E (SHA1NEXTE) added to the message words M[r], which for
+ * r >= 4 are
+ *
+ *   M[r] = SHA1MSG2(SHA1MSG1(M[r-4], M[r-3]) ^ M[r-2], M[r-1])
+ *
+ * Only four of them are live, so m[r % 4] is overwritten in turn.
+ */
+#define SHA1_NI_MSG(r) \
+  m[(r) % 4] = _mm_sha1msg2_epu32( \
+      _mm_xor_si128(_mm_sha1msg1_epu32(m[(r) % 4], m[((r) + 1) % 4]), \
+                    m[((r) + 2) % 4]), \
+      m[((r) + 3) % 4]);
+
+#define SHA1_NI_ROUNDS(r) \
+  e = _mm_sha1nexte_epu32(prev, m[(r) % 4]); \
+  prev = abcd; \
+  abcd = _mm_sha1rnds4_epu32(abcd, e, (r) / 5);
+
+#define SHA1_NI_ROUNDS_MSG(r) \
+  SHA1_NI_MSG(r) \
+  SHA1_NI_ROUNDS(r)
+
+void __attribute__((__target__("sha,ssse3")))
+sha1_compress_shani(uint32_t state[5], const uint8_t *data, size_t blocks)
+{
+  const __m128i bswap =
+    _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+  __m128i abcd, e0;
+
+  abcd = _mm_shuffle_epi32(_mm_loadu_si128((const void *) state), 0x1B);
+  e0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+  for (/* NOTHING */; blocks > 0; blocks--) {
+    __m128i abcd_save = abcd, e0_save = e0, prev, e, m[4];
+    unsigned i;
+
+    for (i = 0; i < 4; i++) {
+      m[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128((const void *) &data[i * 16]), bswap);
+    }
+
+    e = _mm_add_epi32(e0, m[0]);
+    prev = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+    SHA1_NI_ROUNDS(1)
+    SHA1_NI_ROUNDS(2)
+    SHA1_NI_ROUNDS(3)
+    SHA1_NI_ROUNDS_MSG(4)
+    SHA1_NI_ROUNDS_MSG(5)
+    SHA1_NI_ROUNDS_MSG(6)
+    SHA1_NI_ROUNDS_MSG(7)
+    SHA1_NI_ROUNDS_MSG(8)
+    SHA1_NI_ROUNDS_MSG(9)
+    SHA1_NI_ROUNDS_MSG(10)
+    SHA1_NI_ROUNDS_MSG(11)
+    SHA1_NI_ROUNDS_MSG(12)
+    SHA1_NI_ROUNDS_MSG(13)
+    SHA1_NI_ROUNDS_MSG(14)
+    SHA1_NI_ROUNDS_MSG(15)
+    SHA1_NI_ROUNDS_MSG(16)
+    SHA1_NI_ROUNDS_MSG(17)
+    SHA1_NI_ROUNDS_MSG(18)
+    SHA1_NI_ROUNDS_MSG(19)
+
+    e0 = _mm_sha1nexte_epu32(prev, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+    data += 64;
+  }
+
+  _mm_storeu_si128((void *) state, _mm_shuffle_epi32(abcd, 0x1B));
+  state[4] = _mm_cvtsi128_si32(_mm_srli_si128(e0, 12));
+}
+
+#endif /* HAVE_SHA_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS) || defined(HAVE_AVX512_INTRINSICS)
+
+/*
+ * The multi-buffer kernels are a straight vector transcription of the
+ * scalar code, one message per 32-bit lane. The vector primitives V_*
+ * are defined per instruction set below.
+ */
+
+#define V_ROUND(a, b, c, d, e, f, k, w) \
+  e = V_ADD(V_ADD(e, V_ROL(a, 5)), V_ADD(f(b, c, d), V_ADD(V_SET1(k), w))); \
+  b = V_ROL(b, 30);
+
+#define V_W(t) \
+  (w[(t) & 15] = V_ROL(V_XOR(V_XOR(w[((t) - 3) & 15], w[((t) - 8) & 15]), \
+                             V_XOR(w[((t) - 14) & 15], w[(t) & 15])), 1))
+
+#define V_ROUNDS(f, k, t, wt) \
+  V_ROUND(a, b, c, d, e, f, k, wt((t))) \
+  V_ROUND(e, a, b, c, d, f, k, wt((t) + 1)) \
+  V_ROUND(d, e, a, b, c, f, k, wt((t) + 2)) \
+  V_ROUND(c, d, e, a, b, f, k, wt((t) + 3)) \
+  V_ROUND(b, c, d, e, a, f, k, wt((t) + 4))
+
+#define V_WORD(t) w[(t)]
+
+/*
+ * The message words are fetched with gathers; the index vectors hold the
+ * absolute address of the current word of each lane.
+ */
+#define V_COMPRESS(vec, lanes) \
+{ \
+  uint64_t addr[(lanes)]; \
+  vec a, b, c, d, e, aa, bb, cc, dd, ee, w[16]; \
+  V_ADDR p0, p1; \
+  unsigned l, t; \
+\
+  for (l = 0; l < (lanes); l++) { \
+    addr[l] = PTR2UINT(data[l]); \
+  } \
+  p0 = V_LOAD_ADDR(&addr[0]); \
+  p1 = V_LOAD_ADDR(&addr[(lanes) / 2]); \
+  a = V_LOAD(&state[0 * (lanes)]); \
+  b = V_LOAD(&state[1 * (lanes)]); \
+  c = V_LOAD(&state[2 * (lanes)]); \
+  d = V_LOAD(&state[3 * (lanes)]); \
+  e = V_LOAD(&state[4 * (lanes)]); \
+\
+  for (/* NOTHING */; blocks > 0; blocks--) { \
+    for (t = 0; t < 16; t++) { \
+      w[t] = V_BSWAP(V_GATHER(p0, p1)); \
+      p0 = V_ADD_ADDR(p0, 4); \
+      p1 = V_ADD_ADDR(p1, 4); \
+    } \
+\
+    aa = a; \
+    bb = b; \
+    cc = c; \
+    dd = d; \
+    ee = e; \
+    for (t = 0; t < 15; t += 5) { \
+      V_ROUNDS(V_F0, SHA1_K0, t, V_WORD) \
+    } \
+    V_ROUND(a, b, c, d, e, V_F0, SHA1_K0, w[15]) \
+    V_ROUND(e, a, b, c, d, V_F0, SHA1_K0, V_W(16)) \
+    V_ROUND(d, e, a, b, c, V_F0, SHA1_K0, V_W(17)) \
+    V_ROUND(c, d, e, a, b, V_F0, SHA1_K0, V_W(18)) \
+    V_ROUND(b, c, d, e, a, V_F0, SHA1_K0, V_W(19)) \
+    for (t = 20; t < 40; t += 5) { \
+      V_ROUNDS(V_F1, SHA1_K1, t, V_W) \
+    } \
+    for (t = 40; t < 60; t += 5) { \
+      V_ROUNDS(V_F2, SHA1_K2, t, V_W) \
+    } \
+    for (t = 60; t < 80; t += 5) { \
+      V_ROUNDS(V_F1, SHA1_K3, t, V_W) \
+    } \
+    a = V_ADD(a, aa); \
+    b = V_ADD(b, bb); \
+    c = V_ADD(c, cc); \
+    d = V_ADD(d, dd); \
+    e = V_ADD(e, ee); \
+  } \
+\
+  V_STORE(&state[0 * (lanes)], a); \
+  V_STORE(&state[1 * (lanes)], b); \
+  V_STORE(&state[2 * (lanes)], c); \
+  V_STORE(&state[3 * (lanes)], d); \
+  V_STORE(&state[4 * (lanes)], e); \
+}
+
+#if defined(HAVE_AVX2_INTRINSICS)
+
+#define V_XOR(a, b)   _mm256_xor_si256((a), (b))
+#define V_AND(a, b)   _mm256_and_si256((a), (b))
+#define V_OR(a, b)    _mm256_or_si256((a), (b))
+#define V_ADD(a, b)   _mm256_add_epi32((a), (b))
+#define V_ROL(a, n) \
+  _mm256_or_si256(_mm256_slli_epi32((a), (n)), _mm256_srli_epi32((a), 32 - (n)))
+#define V_SET1(v)     _mm256_set1_epi32((int) (v))
+#define V_LOAD(p)     _mm256_loadu_si256((const void *) (p))
+#define V_STORE(p, v) _mm256_storeu_si256((void *) (p), (v))
+#define V_F0(b, c, d) V_XOR((d), V_AND((b), V_XOR((c), (d))))
+#define V_F1(b, c, d) V_XOR(V_XOR((b), (c)), (d))
+#define V_F2(b, c, d) V_OR(V_AND((b), (c)), V_AND((d), V_OR((b), (c))))
+
+#define V_ADDR __m256i
+#define V_LOAD_ADDR(p) _mm256_loadu_si256((const void *) (p))
+#define V_ADD_ADDR(p, n) _mm256_add_epi64((p), _mm256_set1_epi64x(n))
+#define V_GATHER(p0, p1) \
+  _mm256_inserti128_si256(_mm256_castsi128_si256( \
+      _mm256_i64gather_epi32(NULL, (p0), 1)), \
+      _mm256_i64gather_epi32(NULL, (p1), 1), 1)
+#define V_BSWAP(a) \
+  _mm256_shuffle_epi8((a), _mm256_set_epi8( \
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, \
+      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3))
+
+void __attribute__((__target__("avx2")))
+sha1_compress_x8_avx2(const uint8_t * const data[8], size_t blocks,
+    uint32_t state[5 * 8])
+{
+  V_COMPRESS(__m256i, 8)
+}
+
+#undef V_XOR
+#undef V_AND
+#undef V_OR
+#undef V_ADD
+#undef V_ROL
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_F0
+#undef V_F1
+#undef V_F2
+#undef V_ADDR
+#undef V_LOAD_ADDR
+#undef V_ADD_ADDR
+#undef V_GATHER
+#undef V_BSWAP
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_AVX512_INTRINSICS)
+
+#define V_XOR(a, b)   _mm512_xor_si512((a), (b))
+#define V_ADD(a, b)   _mm512_add_epi32((a), (b))
+#define V_ROL(a, n)   _mm512_rol_epi32((a), (n))
+#define V_SET1(v)     _mm512_set1_epi32((int) (v))
+#define V_LOAD(p)     _mm512_loadu_si512((const void *) (p))
+#define V_STORE(p, v) _mm512_storeu_si512((void *) (p), (v))
+/* Choice, parity and majority as ternary logic truth tables */
+#define V_F0(b, c, d) _mm512_ternarylogic_epi32((b), (c), (d), 0xCA)
+#define V_F1(b, c, d) _mm512_ternarylogic_epi32((b), (c), (d), 0x96)
+#define V_F2(b, c, d) _mm512_ternarylogic_epi32((b), (c), (d), 0xE8)
+
+#define V_ADDR __m512i
+#define V_LOAD_ADDR(p) _mm512_loadu_si512((const void *) (p))
+#define V_ADD_ADDR(p, n) _mm512_add_epi64((p), _mm512_set1_epi64(n))
+#define V_GATHER(p0, p1) \
+  _mm512_inserti64x4(_mm512_castsi256_si512( \
+      _mm512_i64gather_epi32((p0), NULL, 1)), \
+      _mm512_i64gather_epi32((p1), NULL, 1), 1)
+/* Byte shuffles need AVX512BW, two rotations do with AVX512F */
+#define V_BSWAP(a) \
+  _mm512_ternarylogic_epi32(_mm512_rol_epi32((a), 8), \
+      _mm512_rol_epi32((a), 24), _mm512_set1_epi32(0x00FF00FF), 0xE4)
+
+void __attribute__((__target__("avx512f")))
+sha1_compress_x16_avx512(const uint8_t * const data[16], size_t blocks,
+    uint32_t state[5 * 16])
+{
+  V_COMPRESS(__m512i, 16)
+}
+
+#undef V_XOR
+#undef V_ADD
+#undef V_ROL
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_F0
+#undef V_F1
+#undef V_F2
+#undef V_ADDR
+#undef V_LOAD_ADDR
+#undef V_ADD_ADDR
+#undef V_GATHER
+#undef V_BSWAP
+
+#endif /* HAVE_AVX512_INTRINSICS */
+
+#endif /* HAVE_AVX2_INTRINSICS || HAVE_AVX512_INTRINSICS */
+
+/* vi: set ai et sts=2 sw=2 cindent: */
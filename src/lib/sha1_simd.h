@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef SHA1_SIMD_HEADER_FILE
+#define SHA1_SIMD_HEADER_FILE
+
+#include "sha1.h"
+
+#define SHA1_ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define SHA1_K0 0x5A827999UL
+#define SHA1_K1 0x6ED9EBA1UL
+#define SHA1_K2 0x8F1BBCDCUL
+#define SHA1_K3 0xCA62C1D6UL
+
+#define SHA1_F0(b, c, d) ((d) ^ ((b) & ((c) ^ (d))))
+#define SHA1_F1(b, c, d) ((b) ^ (c) ^ (d))
+#define SHA1_F2(b, c, d) (((b) & (c)) | ((d) & ((b) | (c))))
+#define SHA1_F3(b, c, d) ((b) ^ (c) ^ (d))
+
+#define SHA1_ROUND(a, b, c, d, e, f, k, w) \
+  e += SHA1_ROL(a, 5) + f(b, c, d) + (k) + (w); \
+  b = SHA1_ROL(b, 30);
+
+/* Expands the next word of the message schedule in place */
+#define SHA1_W(w, t) \
+  (w[(t) & 15] = SHA1_ROL(w[((t) - 3) & 15] ^ w[((t) - 8) & 15] ^ \
+                          w[((t) - 14) & 15] ^ w[(t) & 15], 1))
+
+/*
+ * The SSSE3 and AVX2 kernels calculate the message schedule with vector
+ * instructions, four words (SSSE3) or four words of two blocks (AVX2) at
+ * once; the rounds are done with scalar instructions. The SHA kernel
+ * uses the Intel SHA extensions for both.
+ */
+
+#if defined(HAVE_SSSE3_INTRINSICS)
+void sha1_compress_ssse3(uint32_t state[5], const uint8_t *data,
+    size_t blocks);
+#endif /* HAVE_SSSE3_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+void sha1_compress_avx2(uint32_t state[5], const uint8_t *data,
+    size_t blocks);
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_SHA_INTRINSICS)
+void sha1_compress_shani(uint32_t state[5], const uint8_t *data,
+    size_t blocks);
+#endif /* HAVE_SHA_INTRINSICS */
+
+/*
+ * Multi-buffer kernels: each one compresses "blocks" consecutive blocks
+ * starting at data[l] for every lane l, 8 (AVX2) or 16 (AVX-512) lanes
+ * in all. The chaining values are stored lane-interleaved: state[i *
+ * lanes + l] is the i-th value of lane l.
+ */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+void sha1_compress_x8_avx2(const uint8_t * const data[8], size_t blocks,
+    uint32_t state[5 * 8]);
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_AVX512_INTRINSICS)
+void sha1_compress_x16_avx512(const uint8_t * const data[16], size_t blocks,
+    uint32_t state[5 * 16]);
+#endif /* HAVE_AVX512_INTRINSICS */
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* SHA1_SIMD_HEADER_FILE */
@@ -8,6 +8,9 @@
  */
 
 #include "tiger.h"
+#include "tiger_simd.h"
+#include "kernel.h"
+#include "cpu.h"
 
 /* The following macro denotes that an optimization    */
 /* for 32-bit machines is desired. It is used only for */
@@ -230,4 +233,386 @@ tiger(const void *data, uint64_t length, char hash[24])
   }
 }
 
+#ifdef HAVE_BIG_ENDIAN
+#define TIGER_WORD(p) peek_le64(p)
+#else
+#define TIGER_WORD(p) peek_u64(p)
+#endif /* HAVE_BIG_ENDIAN */
+
+static inline void
+tiger_state_init(uint64_t state[3])
+{
+  state[0] = U64_FROM_2xU32(0x01234567UL, 0x89ABCDEFUL);
+  state[1] = U64_FROM_2xU32(0xFEDCBA98UL, 0x76543210UL);
+  state[2] = U64_FROM_2xU32(0xF096A5B4UL, 0xC3B2E187UL);
+}
+
+static inline void
+tiger_state_digest(const uint64_t state[3], char hash[24])
+{
+  unsigned i;
+
+  for (i = 0; i < 3; i++) {
+    poke_le64(&hash[i * 8], state[i]);
+  }
+}
+
+/* Compresses a 64-byte block of message bytes which needs not be aligned */
+static inline void
+tiger_compress_block(const uint8_t *block, uint64_t state[3])
+{
+  uint64_t x[8];
+  unsigned i;
+
+  for (i = 0; i < 8; i++) {
+    x[i] = TIGER_WORD(&block[i * 8]);
+  }
+  tiger_compress(x, state);
+}
+
+/*
+ * The padding block of a TTH leaf: the last message byte is or'ed into
+ * the lowest byte of the first word, followed by the 0x01 terminator.
+ */
+static const uint64_t tiger_leaf_pad[8] = {
+  0x0100, 0, 0, 0, 0, 0, 0, (uint64_t) TIGER_LEAF_LEN << 3
+};
+
+/**
+ * Calculates the Tiger hash of a TTH leaf, that is exactly TIGER_LEAF_LEN
+ * bytes: the 0x00 prefix followed by 1024 bytes of data. "data" points to
+ * the leaf data only; the prefix is shifted in. As every message word then
+ * straddles two words of the buffer, the data is read at an offset of -1,
+ * except for the very first word which would start before the buffer. The
+ * message length and thus the padding is known at compile time.
+ */
+void
+tiger_leaf_data(const void *data, char hash[24])
+{
+  const uint8_t *p = data;
+  uint64_t state[3], x[8];
+  unsigned i;
+
+  tiger_state_init(state);
+  x[0] = TIGER_WORD(p) << 8;
+  for (i = 1; i < 8; i++) {
+    x[i] = TIGER_WORD(&p[i * 8 - 1]);
+  }
+  tiger_compress(x, state);
+  for (i = 1; i < TIGER_LEAF_LEN / 64; i++) {
+    tiger_compress_block(&p[i * 64 - 1], state);
+  }
+  for (i = 0; i < 8; i++) {
+    x[i] = tiger_leaf_pad[i];
+  }
+  x[0] |= p[TIGER_LEAF_LEN - 2];
+  tiger_compress(x, state);
+  tiger_state_digest(state, hash);
+}
+
+/**
+ * Calculates the Tiger hash of a TTH inner node, that is exactly
+ * TIGER_NODE_LEN bytes: the 0x01 prefix followed by two hashes. "data"
+ * points to the two hashes only; the prefix is shifted in like in
+ * tiger_leaf_data(). The message and its padding fit into a single block.
+ * "hash" may overlap "data".
+ */
+void
+tiger_node_data(const void *data, char hash[24])
+{
+  const uint8_t *p = data;
+  uint64_t state[3], x[8];
+  unsigned i;
+
+  x[0] = (TIGER_WORD(p) << 8) | 0x01;
+  for (i = 1; i < 6; i++) {
+    x[i] = TIGER_WORD(&p[i * 8 - 1]);
+  }
+  x[6] = 0x0100 | p[TIGER_NODE_LEN - 2];
+  x[7] = (uint64_t) TIGER_NODE_LEN << 3;
+
+  tiger_state_init(state);
+  tiger_compress(x, state);
+  tiger_state_digest(state, hash);
+}
+
+/**
+ * Builds the padding block(s) for the last "rest" bytes of a message of
+ * "length" bytes.
+ *
+ * @return the number of padding blocks, either 1 or 2.
+ */
+static unsigned
+tiger_pad(const uint8_t *tail, size_t rest, uint64_t length, uint8_t block[128])
+{
+  size_t size;
+
+  RUNTIME_ASSERT(rest < 64);
+
+  size = rest < 56 ? 64 : 128;
+  memset(block, 0, size);
+  memcpy(block, tail, rest);
+  block[rest] = 0x01;
+  poke_le64(&block[size - 8], length << 3);
+  return size / 64;
+}
+
+/**
+ * Starts the calculation of a Tiger hash whose message is passed to
+ * tiger_update() in arbitrary pieces.
+ */
+void
+tiger_init(struct tiger_ctx *ctx)
+{
+  tiger_state_init(ctx->state);
+  ctx->length = 0;
+}
+
+void
+tiger_update(struct tiger_ctx *ctx, const void *data, size_t size)
+{
+  const uint8_t *p = data;
+  size_t fill = ctx->length % 64;
+
+  ctx->length += size;
+
+  if (fill > 0) {
+    size_t n = MIN(size, 64 - fill);
+
+    memcpy(&ctx->block[fill], p, n);
+    if (fill + n < 64)
+      return;
+
+    tiger_compress_block(ctx->block, ctx->state);
+    p += n;
+    size -= n;
+  }
+
+  for (/* NOTHING */; size >= 64; size -= 64) {
+    tiger_compress_block(p, ctx->state);
+    p += 64;
+  }
+  memcpy(ctx->block, p, size);
+}
+
+void
+tiger_final(struct tiger_ctx *ctx, char hash[24])
+{
+  uint8_t pad[128];
+  unsigned i, blocks;
+
+  blocks = tiger_pad(ctx->block, ctx->length % 64, ctx->length, pad);
+  for (i = 0; i < blocks; i++) {
+    tiger_compress_block(&pad[i * 64], ctx->state);
+  }
+  tiger_state_digest(ctx->state, hash);
+}
+
+typedef void (*tiger_compress_lanes_t)(const uint8_t * const data[],
+  size_t blocks, uint64_t *state);
+
+static void
+tiger_lanes_init(uint64_t state[], unsigned lanes)
+{
+  uint64_t init[3];
+  unsigned i, l;
+
+  tiger_state_init(init);
+  for (l = 0; l < lanes; l++) {
+    for (i = 0; i < 3; i++) {
+      state[i * lanes + l] = init[i];
+    }
+  }
+}
+
+static void
+tiger_lanes_digest(const uint64_t state[], unsigned lanes, size_t n,
+  char hash[][24])
+{
+  unsigned i, l;
+
+  for (l = 0; l < n; l++) {
+    for (i = 0; i < 3; i++) {
+      poke_le64(&hash[l][i * 8], state[i * lanes + l]);
+    }
+  }
+}
+
+/**
+ * Hashes up to "lanes" TTH leaves in parallel like tiger_leaf_data(). Only
+ * the first block of each leaf, which would have to be read from before
+ * the buffer, is assembled in a scratch block; the other blocks are read
+ * from the leaf data at an offset of -1.
+ */
+static void
+tiger_leaves_lanes(const void * const data[], size_t n, unsigned lanes,
+  tiger_compress_lanes_t compress_lanes, char hash[][24])
+{
+  uint64_t state[3 * TIGER_LANES_MAX];
+  uint8_t head[TIGER_LANES_MAX][64], pad[TIGER_LANES_MAX][64];
+  const uint8_t *leaf[TIGER_LANES_MAX], *p[TIGER_LANES_MAX];
+  unsigned i, l;
+
+  RUNTIME_ASSERT(n > 0 && n <= lanes);
+  RUNTIME_ASSERT(lanes <= TIGER_LANES_MAX);
+
+  tiger_lanes_init(state, lanes);
+  for (l = 0; l < lanes; l++) {
+    leaf[l] = data[l < n ? l : 0];
+    head[l][0] = 0; /* flag for leaf calculation */
+    memcpy(&head[l][1], leaf[l], 63);
+    p[l] = head[l];
+  }
+  compress_lanes(p, 1, state);
+
+  for (l = 0; l < lanes; l++) {
+    p[l] = &leaf[l][63];
+  }
+  compress_lanes(p, TIGER_LEAF_LEN / 64 - 1, state);
+
+  for (l = 0; l < lanes; l++) {
+    for (i = 0; i < 8; i++) {
+      poke_le64(&pad[l][i * 8], tiger_leaf_pad[i]);
+    }
+    pad[l][0] = leaf[l][TIGER_LEAF_LEN - 2];
+    p[l] = pad[l];
+  }
+  compress_lanes(p, 1, state);
+  tiger_lanes_digest(state, lanes, n, hash);
+}
+
+/**
+ * Hashes up to "lanes" TTH inner nodes in parallel like tiger_node_data().
+ * "data" holds the pairs of hashes back to back. Each node is a single
+ * block which is assembled in scratch space, so "hash" may overlap
+ * "data".
+ */
+static void
+tiger_nodes_lanes(const uint8_t *data, size_t n, unsigned lanes,
+  tiger_compress_lanes_t compress_lanes, char hash[][24])
+{
+  uint64_t state[3 * TIGER_LANES_MAX];
+  uint8_t block[TIGER_LANES_MAX][64];
+  const uint8_t *p[TIGER_LANES_MAX];
+  unsigned l;
+
+  RUNTIME_ASSERT(n > 0 && n <= lanes);
+  RUNTIME_ASSERT(lanes <= TIGER_LANES_MAX);
+
+  tiger_lanes_init(state, lanes);
+  for (l = 0; l < lanes; l++) {
+    block[l][0] = 0x01; /* flag for inner node calculation */
+    memcpy(&block[l][1], &data[(l < n ? l : 0) * 48], 48);
+    memset(&block[l][TIGER_NODE_LEN], 0, 56 - TIGER_NODE_LEN);
+    block[l][TIGER_NODE_LEN] = 0x01;
+    poke_le64(&block[l][56], (uint64_t) TIGER_NODE_LEN << 3);
+    p[l] = block[l];
+  }
+  compress_lanes(p, 1, state);
+  tiger_lanes_digest(state, lanes, n, hash);
+}
+
+struct tiger_kernel {
+  unsigned lanes;
+  tiger_compress_lanes_t compress_lanes;
+};
+
+#if defined(HAVE_AVX512_INTRINSICS)
+static const struct tiger_kernel tiger_kernel_avx512 = {
+  8, tiger_compress_avx512
+};
+#endif /* HAVE_AVX512_INTRINSICS */
+
+#if defined(HAVE_AVX2_INTRINSICS)
+static const struct tiger_kernel tiger_kernel_avx2 = {
+  4, tiger_compress_avx2
+};
+#endif /* HAVE_AVX2_INTRINSICS */
+
+static const struct tiger_kernel tiger_kernel_scalar = { 1, NULL };
+
+/* Ordered from fastest to slowest */
+static const struct kernel tiger_kernels[] = {
+#if defined(HAVE_AVX512_INTRINSICS)
+  { "avx512", CPU_AVX512F, &tiger_kernel_avx512 },
+#endif /* HAVE_AVX512_INTRINSICS */
+#if defined(HAVE_AVX2_INTRINSICS)
+  { "avx2",   CPU_AVX2,    &tiger_kernel_avx2 },
+#endif /* HAVE_AVX2_INTRINSICS */
+  { "scalar", 0,           &tiger_kernel_scalar },
+};
+
+static const struct tiger_kernel *tiger_kernel;
+
+/**
+ * Selects the multi-lane kernel used by tiger_multi_leaves() and
+ * tiger_multi_nodes(). The round variant of the scalar code depends on
+ * the word size and is still chosen at compile time.
+ */
+void
+tiger_kernel_init(void)
+{
+  tiger_kernel =
+    kernel_select("tiger", tiger_kernels, ARRAY_LEN(tiger_kernels))->data;
+}
+
+/**
+ * Calculates the hashes of "n" TTH leaves like tiger_leaf_data(), that is
+ * data[i] points to 1024 bytes of leaf data without the 0x00 prefix. The
+ * leaves are hashed in place, several at once where the CPU supports it.
+ */
+void
+tiger_multi_leaves(const void * const data[], size_t n, char hash[][24])
+{
+  unsigned lanes;
+
+  if (NULL == tiger_kernel) {
+    tiger_kernel_init();
+  }
+  lanes = tiger_kernel->lanes;
+
+  while (lanes > 1 && n > 1) {
+    size_t k = MIN(n, lanes);
+
+    tiger_leaves_lanes(data, k, lanes, tiger_kernel->compress_lanes, hash);
+    data += k;
+    hash += k;
+    n -= k;
+  }
+  for (/* NOTHING */; n > 0; n--) {
+    tiger_leaf_data(*data++, *hash++);
+  }
+}
+
+/**
+ * Calculates "n" TTH inner nodes like tiger_node_data(). "data" holds the
+ * 2 * n child hashes back to back; node i is the hash over the children
+ * 2 * i and 2 * i + 1. The result may be written over "data", which
+ * reduces a level of the tree in place.
+ */
+void
+tiger_multi_nodes(const void *data, size_t n, char hash[][24])
+{
+  const uint8_t *p = data;
+  unsigned lanes;
+
+  if (NULL == tiger_kernel) {
+    tiger_kernel_init();
+  }
+  lanes = tiger_kernel->lanes;
+
+  while (lanes > 1 && n > 1) {
+    size_t k = MIN(n, lanes);
+
+    tiger_nodes_lanes(p, k, lanes, tiger_kernel->compress_lanes, hash);
+    p += k * 48;
+    hash += k;
+    n -= k;
+  }
+  for (/* NOTHING */; n > 0; n--) {
+    tiger_node_data(p, *hash++);
+    p += 48;
+  }
+}
+
 /* vi: set ai et sts=2 sw=2 cindent: */
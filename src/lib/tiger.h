@@ -9,6 +9,28 @@
 
 #include "common.h"
 
+/* maximum number of leaves or nodes compressed in parallel */
+#define TIGER_LANES_MAX 8
+
+/* message lengths of TTH leaves and inner nodes, including the prefix */
+#define TIGER_LEAF_LEN (1 + 1024)
+#define TIGER_NODE_LEN (1 + 2 * 24)
+
+/* state of a Tiger hash calculated piecewise */
+struct tiger_ctx {
+  uint64_t state[3];
+  uint64_t length;              /* message bytes so far */
+  uint8_t block[64];            /* partial block */
+};
+
 void tiger(const void *data, uint64_t length, char hash[24]);
+void tiger_leaf_data(const void *data, char hash[24]);
+void tiger_node_data(const void *data, char hash[24]);
+void tiger_init(struct tiger_ctx *ctx);
+void tiger_update(struct tiger_ctx *ctx, const void *data, size_t size);
+void tiger_final(struct tiger_ctx *ctx, char hash[24]);
+void tiger_kernel_init(void);
+void tiger_multi_leaves(const void * const data[], size_t n, char hash[][24]);
+void tiger_multi_nodes(const void *data, size_t n, char hash[][24]);
 
 #endif
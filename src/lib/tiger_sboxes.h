@@ -2,7 +2,7 @@
 
 #define D(x, y) ((uint64_t) (x) << 32 | (y))
 
-static const uint64_t tiger_sboxes[4 * 256] = {
+const uint64_t tiger_sboxes[4 * 256] = {
 	D(0x02AAB17CUL, 0xF7E90C5EUL)  /*    0 */,
 	D(0xAC424B03UL, 0xE243A8ECUL)  /*    1 */,
 	D(0x72CD5BE3UL, 0x0DD5FCD3UL)  /*    2 */,
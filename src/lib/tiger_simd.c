@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * tiger_simd.c - Tiger compression of 4 (AVX2) or 8 (AVX-512) independent
+ * messages at once. Each vector lane carries the state of one message, the
+ * S-box lookups are done with 64-bit gathers. This is a straight vector
+ * transcription of the "Alpha" variant in tiger.c.
+ */
+
+#include "tiger_simd.h"
+
+#if defined(HAVE_AVX2_INTRINSICS) || defined(HAVE_AVX512_INTRINSICS)
+
+#include <immintrin.h>
+
+#define U64_FROM_2xU32(hi, lo) (((uint64_t) (hi) << 32) | (lo))
+
+/*
+ * The vector primitives V_* are defined per instruction set below, the
+ * round structure on top of them is shared.
+ */
+
+#define V_SBOX(t, c, shift) \
+  V_GATHER(&tiger_sboxes[256 * (t)], \
+      V_AND(V_SRLI((c), (shift)), V_SET1(0xFF)), 8)
+
+#define V_MUL(b, mul) \
+  ((mul) == 5 ? V_ADD(V_SLLI((b), 2), (b)) : \
+   (mul) == 7 ? V_SUB(V_SLLI((b), 3), (b)) : \
+                V_ADD(V_SLLI((b), 3), (b)))
+
+#define V_ROUND(a, b, c, x, mul) \
+      c = V_XOR(c, x); \
+      a = V_SUB(a, V_XOR(V_XOR(V_SBOX(0, c, 0*8), V_SBOX(1, c, 2*8)), \
+                         V_XOR(V_SBOX(2, c, 4*8), V_SBOX(3, c, 6*8)))); \
+      b = V_ADD(b, V_XOR(V_XOR(V_SBOX(3, c, 1*8), V_SBOX(2, c, 3*8)), \
+                         V_XOR(V_SBOX(1, c, 5*8), V_SBOX(0, c, 7*8)))); \
+      b = V_MUL(b, mul);
+
+#define V_PASS(a, b, c, mul) \
+      V_ROUND(a, b, c, x0, mul) \
+      V_ROUND(b, c, a, x1, mul) \
+      V_ROUND(c, a, b, x2, mul) \
+      V_ROUND(a, b, c, x3, mul) \
+      V_ROUND(b, c, a, x4, mul) \
+      V_ROUND(c, a, b, x5, mul) \
+      V_ROUND(a, b, c, x6, mul) \
+      V_ROUND(b, c, a, x7, mul)
+
+#define V_NOT(x) V_XOR((x), V_SET1(~(uint64_t) 0))
+
+#define V_KEY_SCHEDULE \
+      x0 = V_SUB(x0, V_XOR(x7, V_SET1(U64_FROM_2xU32(0xA5A5A5A5UL, \
+                                                    0xA5A5A5A5UL)))); \
+      x1 = V_XOR(x1, x0); \
+      x2 = V_ADD(x2, x1); \
+      x3 = V_SUB(x3, V_XOR(x2, V_SLLI(V_NOT(x1), 19))); \
+      x4 = V_XOR(x4, x3); \
+      x5 = V_ADD(x5, x4); \
+      x6 = V_SUB(x6, V_XOR(x5, V_SRLI(V_NOT(x4), 23))); \
+      x7 = V_XOR(x7, x6); \
+      x0 = V_ADD(x0, x7); \
+      x1 = V_SUB(x1, V_XOR(x0, V_SLLI(V_NOT(x7), 19))); \
+      x2 = V_XOR(x2, x1); \
+      x3 = V_ADD(x3, x2); \
+      x4 = V_SUB(x4, V_XOR(x3, V_SRLI(V_NOT(x2), 23))); \
+      x5 = V_XOR(x5, x4); \
+      x6 = V_ADD(x6, x5); \
+      x7 = V_SUB(x7, V_XOR(x6, V_SET1(U64_FROM_2xU32(0x01234567UL, \
+                                                    0x89ABCDEFUL))));
+
+/*
+ * The message words are fetched with a gather as well; the index vector
+ * holds the absolute address of the current word of each lane.
+ */
+#define V_COMPRESS(vec, lanes) \
+{ \
+  uint64_t addr[(lanes)]; \
+  vec a, b, c, aa, bb, cc, p; \
+  vec x0, x1, x2, x3, x4, x5, x6, x7; \
+  unsigned l; \
+\
+  for (l = 0; l < (lanes); l++) { \
+    addr[l] = PTR2UINT(data[l]); \
+  } \
+  p = V_LOAD(addr); \
+  a = V_LOAD(&state[0 * (lanes)]); \
+  b = V_LOAD(&state[1 * (lanes)]); \
+  c = V_LOAD(&state[2 * (lanes)]); \
+\
+  for (/* NOTHING */; blocks > 0; blocks--) { \
+    x0 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x1 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x2 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x3 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x4 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x5 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x6 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+    x7 = V_GATHER(NULL, p, 1); p = V_ADD(p, V_SET1(8)); \
+\
+    aa = a; \
+    bb = b; \
+    cc = c; \
+    V_PASS(a, b, c, 5) \
+    V_KEY_SCHEDULE \
+    V_PASS(c, a, b, 7) \
+    V_KEY_SCHEDULE \
+    V_PASS(b, c, a, 9) \
+    a = V_XOR(a, aa); \
+    b = V_SUB(b, bb); \
+    c = V_ADD(c, cc); \
+  } \
+\
+  V_STORE(&state[0 * (lanes)], a); \
+  V_STORE(&state[1 * (lanes)], b); \
+  V_STORE(&state[2 * (lanes)], c); \
+}
+
+#if defined(HAVE_AVX2_INTRINSICS)
+
+#define V_XOR(a, b)   _mm256_xor_si256((a), (b))
+#define V_AND(a, b)   _mm256_and_si256((a), (b))
+#define V_ADD(a, b)   _mm256_add_epi64((a), (b))
+#define V_SUB(a, b)   _mm256_sub_epi64((a), (b))
+#define V_SLLI(a, n)  _mm256_slli_epi64((a), (n))
+#define V_SRLI(a, n)  _mm256_srli_epi64((a), (n))
+#define V_SET1(v)     _mm256_set1_epi64x((long long) (v))
+#define V_LOAD(p)     _mm256_loadu_si256((const void *) (p))
+#define V_STORE(p, v) _mm256_storeu_si256((void *) (p), (v))
+#define V_GATHER(base, idx, scale) \
+  _mm256_i64gather_epi64((const long long *) (base), (idx), (scale))
+
+void __attribute__((__target__("avx2")))
+tiger_compress_avx2(const uint8_t * const data[4], size_t blocks,
+  uint64_t state[3 * 4])
+{
+  V_COMPRESS(__m256i, 4)
+}
+
+#undef V_XOR
+#undef V_AND
+#undef V_ADD
+#undef V_SUB
+#undef V_SLLI
+#undef V_SRLI
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_GATHER
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_AVX512_INTRINSICS)
+
+#define V_XOR(a, b)   _mm512_xor_si512((a), (b))
+#define V_AND(a, b)   _mm512_and_si512((a), (b))
+#define V_ADD(a, b)   _mm512_add_epi64((a), (b))
+#define V_SUB(a, b)   _mm512_sub_epi64((a), (b))
+#define V_SLLI(a, n)  _mm512_slli_epi64((a), (n))
+#define V_SRLI(a, n)  _mm512_srli_epi64((a), (n))
+#define V_SET1(v)     _mm512_set1_epi64((long long) (v))
+#define V_LOAD(p)     _mm512_loadu_si512((const void *) (p))
+#define V_STORE(p, v) _mm512_storeu_si512((void *) (p), (v))
+#define V_GATHER(base, idx, scale) \
+  _mm512_i64gather_epi64((idx), (const void *) (base), (scale))
+
+void __attribute__((__target__("avx512f")))
+tiger_compress_avx512(const uint8_t * const data[8], size_t blocks,
+  uint64_t state[3 * 8])
+{
+  V_COMPRESS(__m512i, 8)
+}
+
+#undef V_XOR
+#undef V_AND
+#undef V_ADD
+#undef V_SUB
+#undef V_SLLI
+#undef V_SRLI
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_GATHER
+
+#endif /* HAVE_AVX512_INTRINSICS */
+
+#endif /* HAVE_AVX2_INTRINSICS || HAVE_AVX512_INTRINSICS */
+
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * tiger_simd.h - Multi-lane Tiger compression functions
+ *
+ * Each function compresses "blocks" consecutive 64-byte blocks starting
+ * at data[l] for every lane l. The chaining values are stored
+ * lane-interleaved: state[i * lanes + l] is the i-th value of lane l.
+ * The input is read as little-endian words, so these are only available
+ * on x86.
+ */
+
+#ifndef TIGER_SIMD_H
+#define TIGER_SIMD_H
+
+#include "common.h"
+
+extern const uint64_t tiger_sboxes[4 * 256];
+
+#if defined(HAVE_AVX2_INTRINSICS)
+void tiger_compress_avx2(const uint8_t * const data[4], size_t blocks,
+  uint64_t state[3 * 4]);
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if defined(HAVE_AVX512_INTRINSICS)
+void tiger_compress_avx512(const uint8_t * const data[8], size_t blocks,
+  uint64_t state[3 * 8]);
+#endif /* HAVE_AVX512_INTRINSICS */
+
+#endif /* TIGER_SIMD_H */
+/* vi: set ai et sts=2 sw=2 cindent: */
@@ -23,16 +23,56 @@
 
 #include "tigertree.h"
 
+/* start the next leaf; its data is hashed as it arrives */
+static void
+tt_leaf_init(TT_CONTEXT *ctx)
+{
+  static const char prefix = 0; /* flag for leaf calculation */
+
+  tiger_init(&ctx->leaf);
+  tiger_update(&ctx->leaf, &prefix, 1);
+  ctx->index = 0;
+}
+
 /* Initialize the tigertree context */
 void
 tt_init(TT_CONTEXT *ctx)
 {
+  STATIC_ASSERT(TIGER_LEAF_LEN == 1 + TTH_BLOCKSIZE);
+  STATIC_ASSERT(TIGER_NODE_LEN == 1 + TTH_NODESIZE);
+
   ctx->count = 0;
-  ctx->leaf[0] = 0; /* flag for leaf  calculation -- never changed */
-  ctx->node[0] = 1; /* flag for inner node calculation -- never changed */
-  ctx->block = ctx->leaf + 1 ; /* working area for blocks */
-  ctx->index = 0;   /* partial block pointer/block length */
   ctx->top = ctx->nodes;
+  ctx->hooked = false;
+  ctx->leaf_cb = NULL;
+  ctx->node_cb = NULL;
+  ctx->udata = NULL;
+  ctx->node_level = 0;
+  ctx->thex = NULL;
+  tt_leaf_init(ctx);
+}
+
+/*
+ * Initializes "ctx" like tt_init() and registers callbacks which are
+ * called with "udata" while hashing: "leaf_cb" for the hash of each leaf
+ * and "node_cb" for each node "node_level" levels above the leaves, in
+ * the order of the input. Either may be NULL. The last node of that
+ * level covers fewer leaves unless the input fills it, so it is only
+ * known and reported by tt_digest(). Like tt_init_thex(), this must not
+ * be combined with tt_subtree().
+ */
+void
+tt_init_callback(TT_CONTEXT *ctx, tt_callback leaf_cb,
+    tt_callback node_cb, unsigned node_level, void *udata)
+{
+  RUNTIME_ASSERT(node_level < 64);
+
+  tt_init(ctx);
+  ctx->leaf_cb = leaf_cb;
+  ctx->node_cb = node_cb;
+  ctx->node_level = node_level;
+  ctx->udata = udata;
+  ctx->hooked = leaf_cb || node_cb;
 }
 
 static void
@@ -40,19 +80,23 @@ tt_compose(TT_CONTEXT *ctx)
 {
   char *node = ctx->top - TTH_NODESIZE;
 
-  memmove(&ctx->node[1], node, TTH_NODESIZE); /* copy to scratch area */
-  /* combine two nodes */
-  tiger(ctx->node, TTH_NODESIZE + 1, ctx->top);
-  memmove(node,ctx->top,TIGERSIZE);           /* move up result */
+  tiger_node_data(node, node);                /* combine two nodes */
   ctx->top -= TIGERSIZE;                      /* update top ptr */
 }
 
+static void tt_push_hooked(TT_CONTEXT *ctx);
+
+/* push the leaf hash stored at the top and combine completed subtrees */
 static void
-tt_block(TT_CONTEXT *ctx)
+tt_push(TT_CONTEXT *ctx)
 {
   uint64_t b;
 
-  tiger(ctx->leaf, ctx->index + 1, ctx->top);
+  if (ctx->hooked) {
+    tt_push_hooked(ctx);
+    return;
+  }
+
   ctx->top += TIGERSIZE;
   ++ctx->count;
   b = ctx->count;
@@ -62,6 +106,35 @@ tt_block(TT_CONTEXT *ctx)
   }
 }
 
+/* finish the leaf in progress */
+static void
+tt_block(TT_CONTEXT *ctx)
+{
+  tiger_final(&ctx->leaf, ctx->top);
+  tt_push(ctx);
+  tt_leaf_init(ctx);
+}
+
+/* hash up to TIGER_LANES_MAX full leaves in place */
+static void
+tt_blocks(TT_CONTEXT *ctx, const char *buffer, size_t n)
+{
+  const void *leaves[TIGER_LANES_MAX];
+  char hash[TIGER_LANES_MAX][TIGERSIZE];
+  size_t i;
+
+  RUNTIME_ASSERT(n <= TIGER_LANES_MAX);
+
+  for (i = 0; i < n; i++) {
+    leaves[i] = &buffer[i * TTH_BLOCKSIZE];
+  }
+  tiger_multi_leaves(leaves, n, hash);
+  for (i = 0; i < n; i++) {
+    memcpy(ctx->top, hash[i], TIGERSIZE);
+    tt_push(ctx);
+  }
+}
+
 void
 tt_update(TT_CONTEXT *ctx, const void *data, size_t len)
 {
@@ -70,12 +143,11 @@ tt_update(TT_CONTEXT *ctx, const void *data, size_t len)
   if (ctx->index) { /* Try to fill partial block */
  	unsigned left = TTH_BLOCKSIZE - ctx->index;
   	if (len < left) {
-		memmove(ctx->block + ctx->index, buffer, len);
+		tiger_update(&ctx->leaf, buffer, len);
 		ctx->index += len;
 		return; /* Finished */
 	} else {
-		memmove(ctx->block + ctx->index, buffer, left);
-		ctx->index = TTH_BLOCKSIZE;
+		tiger_update(&ctx->leaf, buffer, left);
 		tt_block(ctx);
 		buffer += left;
 		len -= left;
@@ -83,16 +155,16 @@ tt_update(TT_CONTEXT *ctx, const void *data, size_t len)
   }
 
   while (len >= TTH_BLOCKSIZE) {
-	memmove(ctx->block, buffer, TTH_BLOCKSIZE);
-	ctx->index = TTH_BLOCKSIZE;
-	tt_block(ctx);
-	buffer += TTH_BLOCKSIZE;
-	len -= TTH_BLOCKSIZE;
+	size_t n = MIN(len / TTH_BLOCKSIZE, TIGER_LANES_MAX);
+
+	tt_blocks(ctx, buffer, n);
+	buffer += n * TTH_BLOCKSIZE;
+	len -= n * TTH_BLOCKSIZE;
   }
   ctx->index = len;
   if (0 != len) {
-	/* Buffer leftovers */
-	memmove(ctx->block, buffer, len);
+	/* Start the next leaf with the leftovers */
+	tiger_update(&ctx->leaf, buffer, len);
   }
 }
 
@@ -107,14 +179,336 @@ tt_final(TT_CONTEXT *ctx)
   }
 }
 
+static void tt_thex_finish(TT_CONTEXT *ctx);
+
+/*
+ * Calculates the node above the subtrees on top of the stack which make
+ * up the last "rest" leaves, the incomplete last node of a level.
+ */
+static void
+tt_stack_node(const TT_CONTEXT *ctx, uint64_t rest, char node[TIGERSIZE])
+{
+  const char *entry = ctx->top - TIGERSIZE;
+  char buf[TTH_NODESIZE];
+  uint64_t b;
+
+  /* One subtree per bit of "rest", smallest on top */
+  memcpy(node, entry, TIGERSIZE);
+  for (b = rest & (rest - 1); 0 != b; b &= b - 1) {
+    entry -= TIGERSIZE;
+    memcpy(buf, entry, TIGERSIZE);
+    memcpy(&buf[TIGERSIZE], node, TIGERSIZE);
+    tiger_node_data(buf, node);
+  }
+}
+
+/* reports the incomplete last node to "node_cb", if there is one */
+static void
+tt_callback_finish(TT_CONTEXT *ctx)
+{
+  uint64_t rest;
+
+  rest = ctx->count & (((uint64_t) 1 << ctx->node_level) - 1);
+  if (0 != rest) {
+    char node[TIGERSIZE];
+
+    tt_stack_node(ctx, rest, node);
+    ctx->node_cb(node, ctx->udata);
+  }
+}
+
 void
 tt_digest(TT_CONTEXT *ctx, char hash[TIGERSIZE])
 {
   tt_final(ctx);
+  if (ctx->node_cb) {
+    tt_callback_finish(ctx);
+  }
+  if (ctx->thex) {
+    tt_thex_finish(ctx);
+  }
   while (ctx->top - TIGERSIZE > ctx->nodes) {
     tt_compose(ctx);
   }
   memmove(hash, ctx->nodes, TIGERSIZE);
 }
 
+/*
+ * Hashes the leaves of "len" bytes of consecutive input into "hashes",
+ * full leaves several at once; only the last leaf may be partial. Like
+ * tt_digest(), an empty input has a single empty leaf. Together with
+ * tt_combine() this calculates the tree breadth-first, one level at a
+ * time.
+ *
+ * Returns the number of leaves.
+ */
+size_t
+tt_leaves(const void *data, size_t len, char (*hashes)[TIGERSIZE])
+{
+  const char *buffer = data;
+  const void *leaves[TIGER_LANES_MAX];
+  size_t i, j, n, rest;
+
+  n = len / TTH_BLOCKSIZE;
+  for (i = 0; i < n; i += j) {
+    for (j = 0; j < TIGER_LANES_MAX && i + j < n; j++) {
+      leaves[j] = &buffer[(i + j) * TTH_BLOCKSIZE];
+    }
+    tiger_multi_leaves(leaves, j, &hashes[i]);
+  }
+
+  rest = len % TTH_BLOCKSIZE;
+  if (0 != rest || 0 == len) {
+    static const char prefix = 0; /* flag for leaf calculation */
+    struct tiger_ctx leaf;
+
+    tiger_init(&leaf);
+    tiger_update(&leaf, &prefix, 1);
+    tiger_update(&leaf, &buffer[n * TTH_BLOCKSIZE], rest);
+    tiger_final(&leaf, hashes[n++]);
+  }
+  return n;
+}
+
+/*
+ * Appends the root of a complete subtree of consecutive leaves which was
+ * hashed elsewhere. All subtrees must be of the same height, except for
+ * the last one which may be smaller. This must not be mixed with
+ * tt_update() on the same context; tt_digest() returns the root as usual.
+ */
+void
+tt_subtree(TT_CONTEXT *ctx, const char hash[TIGERSIZE])
+{
+  memcpy(ctx->top, hash, TIGERSIZE);
+  tt_push(ctx);
+}
+
+/*
+ * Calculates the root over "n" leaf hashes or subtree roots of consecutive
+ * leaf ranges. All subtrees must be complete and of the same height,
+ * except for the last one which may be smaller. Each level is reduced in
+ * place with one batch of node hashes and an odd node is promoted to the
+ * next level, which results in the same tree as tt_digest(). The array is
+ * used as scratch space.
+ */
+void
+tt_combine(char (*hashes)[TIGERSIZE], size_t n, char hash[TIGERSIZE])
+{
+  RUNTIME_ASSERT(n > 0);
+
+  while (n > 1) {
+    size_t pairs = n / 2;
+
+    tiger_multi_nodes(hashes, pairs, hashes);
+    if (n & 1) {
+      memmove(hashes[pairs], hashes[n - 1], TIGERSIZE);
+    }
+    n -= pairs;
+  }
+  memmove(hash, hashes[0], TIGERSIZE);
+}
+
+/*
+ * THEX tree export
+ *
+ * Only the nodes of the bottom level of the exported tree are collected
+ * while hashing; it is the lowest level with at most 2^(depth - 1) nodes.
+ * As that is not known before the end of the input, the nodes are
+ * collected from the leaves on, and each time there are too many, pairs
+ * of them are combined and collection continues one level higher up. A
+ * node which is left without a partner is dropped, it is still on the
+ * stack and becomes part of the next node of the higher level. The
+ * levels above the bottom are calculated at the end.
+ */
+
+struct tt_thex {
+  unsigned depth;               /* levels asked for */
+  unsigned level;               /* height of "nodes" above the leaves */
+  size_t n;                     /* number of "nodes" */
+  size_t max;                   /* 2^(depth - 1) */
+  char (*nodes)[TIGERSIZE];     /* completed nodes at "level", max + 1 */
+  char (*tree)[TIGERSIZE];      /* the serialized tree */
+  size_t tree_nodes;
+  unsigned tree_depth;
+};
+
+/**
+ * Allocates a collector for a THEX tree of up to "depth" levels,
+ * including the root.
+ *
+ * @return NULL on failure with errno set.
+ */
+struct tt_thex *
+tt_thex_new(unsigned depth)
+{
+  struct tt_thex *thex;
+
+  if (depth < 1 || depth > TT_THEX_DEPTH_MAX) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  thex = calloc(1, sizeof *thex);
+  if (!thex)
+    return NULL;
+
+  thex->depth = depth;
+  thex->max = (size_t) 1 << (depth - 1);
+  thex->nodes = malloc((thex->max + 1) * sizeof thex->nodes[0]);
+
+  /* Each level has at most half the nodes of the one below plus one */
+  thex->tree = malloc((2 * thex->max + depth) * sizeof thex->tree[0]);
+  if (!thex->nodes || !thex->tree) {
+    tt_thex_free(thex);
+    errno = ENOMEM;
+    return NULL;
+  }
+  return thex;
+}
+
+void
+tt_thex_free(struct tt_thex *thex)
+{
+  if (thex) {
+    free(thex->nodes);
+    free(thex->tree);
+    free(thex);
+  }
+}
+
+/**
+ * Initializes "ctx" like tt_init() and collects the tree of the input
+ * in "thex", which is available after tt_digest(). This must not be
+ * combined with tt_subtree().
+ */
+void
+tt_init_thex(TT_CONTEXT *ctx, struct tt_thex *thex)
+{
+  tt_init(ctx);
+  ctx->thex = thex;
+  ctx->hooked = true;
+  thex->level = 0;
+  thex->n = 0;
+  thex->tree_nodes = 0;
+  thex->tree_depth = 0;
+}
+
+/* moves the collected nodes one level up */
+static void
+tt_thex_raise(struct tt_thex *thex)
+{
+  tiger_multi_nodes(thex->nodes, thex->n / 2, thex->nodes);
+  thex->n /= 2;
+  thex->level++;
+}
+
+static void
+tt_thex_collect(struct tt_thex *thex, const char *node)
+{
+  memcpy(thex->nodes[thex->n++], node, TIGERSIZE);
+  if (thex->n > thex->max) {
+    tt_thex_raise(thex);
+  }
+}
+
+/*
+ * tt_push() which calls the callbacks and collects each completed node
+ * at the level of "thex"
+ */
+static void
+tt_push_hooked(TT_CONTEXT *ctx)
+{
+  struct tt_thex *thex = ctx->thex;
+  unsigned height;
+  uint64_t b;
+
+  ctx->top += TIGERSIZE;
+  ++ctx->count;
+  if (ctx->leaf_cb) {
+    ctx->leaf_cb(ctx->top - TIGERSIZE, ctx->udata);
+  }
+  b = ctx->count;
+  for (height = 0; /* NOTHING */; height++) {
+    if (ctx->node_cb && height == ctx->node_level) {
+      ctx->node_cb(ctx->top - TIGERSIZE, ctx->udata);
+    }
+
+    /*
+     * After moving up, the node on top may already be part of the
+     * collected ones, so check that it is the next one.
+     */
+    if (
+      thex &&
+      height == thex->level &&
+      (ctx->count >> height) == thex->n + 1
+    ) {
+      tt_thex_collect(thex, ctx->top - TIGERSIZE);
+    }
+    if (b & 1)
+      break;
+    tt_compose(ctx);
+    b >>= 1;
+  }
+}
+
+/*
+ * Adds the incomplete last node of the bottom level, which consists of
+ * the subtrees on top of the stack, and serializes the tree breadth-first
+ * from the root down. Each level is stored in front of the one below it.
+ */
+static void
+tt_thex_finish(TT_CONTEXT *ctx)
+{
+  struct tt_thex *thex = ctx->thex;
+  uint64_t rest;
+  size_t n, total;
+  char (*level)[TIGERSIZE];
+
+  for (;;) {
+    rest = ctx->count & (((uint64_t) 1 << thex->level) - 1);
+    if (thex->n + (0 != rest) <= thex->max)
+      break;
+    tt_thex_raise(thex);
+  }
+
+  if (0 != rest) {
+    tt_stack_node(ctx, rest, thex->nodes[thex->n++]);
+  }
+
+  total = 0;
+  thex->tree_depth = 0;
+  for (n = thex->n; /* NOTHING */; n = (n + 1) / 2) {
+    total += n;
+    thex->tree_depth++;
+    if (1 == n)
+      break;
+  }
+  thex->tree_nodes = total;
+
+  level = &thex->tree[total - thex->n];
+  memcpy(level, thex->nodes, thex->n * sizeof thex->nodes[0]);
+  for (n = thex->n; n > 1; n = (n + 1) / 2) {
+    char (*above)[TIGERSIZE] = level - (n + 1) / 2;
+
+    tiger_multi_nodes(level, n / 2, above);
+    if (n & 1) {
+      memcpy(above[n / 2], level[n - 1], TIGERSIZE);
+    }
+    level = above;
+  }
+}
+
+/**
+ * @return the serialized tree after tt_digest(), the root first and each
+ * level after the one above, with its size in bytes and its number of
+ * levels, which is less than asked for if the input is small.
+ */
+const char *
+tt_thex_tree(const struct tt_thex *thex, size_t *size, unsigned *depth)
+{
+  *size = thex->tree_nodes * TIGERSIZE;
+  *depth = thex->tree_depth;
+  return thex->tree[0];
+}
+
 /* vi: set ai et sts=2 sw=2 cindent: */
@@ -24,20 +24,40 @@
  * longer than 2^64 in size), havoc may ensue. */
 #define TTH_STACKSIZE (TIGERSIZE*56)
 
+/* deepest THEX tree which can be exported, at most 2^20 - 1 nodes */
+#define TT_THEX_DEPTH_MAX 20
+
 typedef void (*tt_callback)(const char hash[TIGERSIZE], void *udata);
 
+struct tt_thex;
+
 typedef struct tt_context {
   uint64_t count;               /* total blocks processed */
-  char leaf[1+TTH_BLOCKSIZE];	/* leaf in progress */
-  char *block;           	/* leaf data */
-  char node[1+TTH_NODESIZE];	/* node scratch space */
-  int index;                    /* index into block */
+  struct tiger_ctx leaf;	/* hash of the leaf in progress */
+  int index;                    /* bytes of the leaf in progress */
   char *top;             	/* top (next empty) stack slot */
+  bool hooked;                  /* any of the following is set */
+  tt_callback leaf_cb;          /* called for each leaf or NULL */
+  tt_callback node_cb;          /* called for each node at "node_level" */
+  void *udata;                  /* passed to the callbacks */
+  unsigned node_level;          /* height of the nodes for "node_cb" */
+  struct tt_thex *thex;         /* tree to export or NULL */
   char nodes[TTH_STACKSIZE];	/* stack of interim node values */
 } TT_CONTEXT;
 
 void tt_init(TT_CONTEXT *ctx);
+void tt_init_callback(TT_CONTEXT *ctx, tt_callback leaf_cb,
+    tt_callback node_cb, unsigned node_level, void *udata);
 void tt_update(TT_CONTEXT *ctx, const void *data, size_t len);
 void tt_digest(TT_CONTEXT *ctx, char hash[TIGERSIZE]);
+size_t tt_leaves(const void *data, size_t len, char (*hashes)[TIGERSIZE]);
+void tt_subtree(TT_CONTEXT *ctx, const char hash[TIGERSIZE]);
+void tt_combine(char (*hashes)[TIGERSIZE], size_t n, char hash[TIGERSIZE]);
+
+struct tt_thex *tt_thex_new(unsigned depth);
+void tt_thex_free(struct tt_thex *thex);
+void tt_init_thex(TT_CONTEXT *ctx, struct tt_thex *thex);
+const char *tt_thex_tree(const struct tt_thex *thex, size_t *size,
+    unsigned *depth);
 
 #endif /* TIGERTREE_HEADER_FILE */
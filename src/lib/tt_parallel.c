@@ -0,0 +1,917 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "tt_parallel.h"
+
+#ifdef HAVE_PTHREAD_SUPPORT
+
+/* limits the memory used for the subtree roots to 1.5 MiB */
+#define TT_PARALLEL_CHUNKS_MAX  65536
+
+/* read buffer of each thread, a multiple of TTH_BLOCKSIZE */
+#define TT_PARALLEL_BUFSIZE     (128 * 1024)
+
+/*
+ * Each subtree is hashed breadth-first: all leaf hashes are collected in
+ * an array which tt_combine() then reduces level by level, so the leaves
+ * as well as the inner nodes are hashed in batches.
+ */
+
+struct tt_parallel {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;          /* signaled when a stolen subtree is done */
+  pthread_t *threads;
+  unsigned num_threads;
+  int fd;
+  uint64_t offset;              /* file offset of the input */
+  uint64_t size;                /* input length */
+  uint64_t chunk;               /* bytes per subtree, a power of two */
+  size_t n;                     /* number of subtrees */
+  size_t next;                  /* next subtree to hash; under lock */
+  size_t back;                  /* subtrees from here on are taken; ditto */
+  unsigned busy;                /* stolen subtrees being hashed; ditto */
+  int error;                    /* errno of the first failure; under lock */
+  bool nocache;                 /* drop the data from the page cache */
+  char (*roots)[TIGERSIZE];     /* subtree roots */
+};
+
+/* hash subtree "i" into its slot of tp->roots */
+static int
+tt_parallel_hash(struct tt_parallel *tp, size_t i, char *buf,
+    char (*leaves)[TIGERSIZE])
+{
+  uint64_t pos, end;
+  size_t n = 0;
+
+  pos = i * tp->chunk;
+  end = MIN(tp->size, pos + tp->chunk);
+
+  while (pos < end) {
+    size_t fill = 0, size = MIN(end - pos, TT_PARALLEL_BUFSIZE);
+
+    /* Only the last leaf of the input may be partial */
+    while (fill < size) {
+      ssize_t ret;
+
+      ret = pread(tp->fd, &buf[fill], size - fill, tp->offset + pos + fill);
+      if ((ssize_t) -1 == ret) {
+        if (EINTR == errno || EAGAIN == errno)
+          continue;
+        return -1;
+      } else if (0 == ret) {
+        errno = EIO; /* the file was truncated meanwhile */
+        return -1;
+      }
+      fill += (size_t) ret;
+    }
+    n += tt_leaves(buf, size, &leaves[n]);
+#ifdef POSIX_FADV_DONTNEED
+    if (tp->nocache) {
+      posix_fadvise(tp->fd, tp->offset + pos, size, POSIX_FADV_DONTNEED);
+    }
+#endif /* POSIX_FADV_DONTNEED */
+    pos += size;
+  }
+  tt_combine(leaves, n, tp->roots[i]);
+  return 0;
+}
+
+static void
+tt_parallel_fail(struct tt_parallel *tp, int error)
+{
+  pthread_mutex_lock(&tp->lock);
+  if (0 == tp->error) {
+    tp->error = error;
+  }
+  pthread_mutex_unlock(&tp->lock);
+}
+
+static void *
+tt_parallel_worker(void *arg)
+{
+  struct tt_parallel *tp = arg;
+  char (*leaves)[TIGERSIZE];
+  char *buf;
+
+  buf = malloc(TT_PARALLEL_BUFSIZE);
+  leaves = calloc(tp->chunk / TTH_BLOCKSIZE, sizeof leaves[0]);
+  if (!buf || !leaves) {
+    tt_parallel_fail(tp, errno);
+    free(leaves);
+    free(buf);
+    return NULL;
+  }
+
+  for (;;) {
+    size_t i;
+
+    pthread_mutex_lock(&tp->lock);
+    i = 0 == tp->error && tp->next < tp->back ? tp->next++ : tp->n;
+    pthread_mutex_unlock(&tp->lock);
+
+    if (i >= tp->n)
+      break;
+
+    if (tt_parallel_hash(tp, i, buf, leaves)) {
+      tt_parallel_fail(tp, errno);
+      break;
+    }
+  }
+
+  free(leaves);
+  free(buf);
+  return NULL;
+}
+
+/**
+ * Starts hashing "size" bytes of "fd" from "offset" on, which should be
+ * at least twice TT_PARALLEL_CHUNK. The data is read with pread() so the
+ * file offset is left alone. jobs - 1 threads are started; the calling
+ * thread joins them in tt_parallel_finish(). With "nocache", the data is
+ * dropped from the page cache once it is hashed.
+ *
+ * @return NULL on failure.
+ */
+struct tt_parallel *
+tt_parallel_file(int fd, uint64_t offset, uint64_t size, unsigned jobs,
+    bool nocache)
+{
+  struct tt_parallel *tp;
+  unsigned i;
+
+  RUNTIME_ASSERT(jobs > 0);
+
+  tp = calloc(1, sizeof *tp);
+  if (!tp)
+    return NULL;
+
+  tp->fd = fd;
+  tp->offset = offset;
+  tp->size = size;
+  tp->nocache = nocache;
+  tp->chunk = TT_PARALLEL_CHUNK;
+  while (size / tp->chunk >= TT_PARALLEL_CHUNKS_MAX) {
+    tp->chunk <<= 1;
+  }
+  tp->n = MAX(1, size / tp->chunk + (0 != size % tp->chunk));
+  tp->back = tp->n;
+
+  tp->roots = calloc(tp->n, sizeof tp->roots[0]);
+  tp->threads = calloc(jobs, sizeof tp->threads[0]);
+  if (!tp->roots || !tp->threads) {
+    free(tp->roots);
+    free(tp->threads);
+    free(tp);
+    return NULL;
+  }
+
+  pthread_mutex_init(&tp->lock, NULL);
+  pthread_cond_init(&tp->cond, NULL);
+  for (i = 1; i < jobs; i++) {
+    if (pthread_create(&tp->threads[tp->num_threads], NULL,
+          tt_parallel_worker, tp))
+      break;
+    tp->num_threads++;
+  }
+  return tp;
+}
+
+/**
+ * Lets the calling thread help with the remaining subtrees, waits for
+ * all threads and combines the subtree roots. "tp" is freed.
+ *
+ * @return 0 on success, -1 on failure with errno set.
+ */
+int
+tt_parallel_finish(struct tt_parallel *tp, char hash[TIGERSIZE])
+{
+  unsigned i;
+  int error;
+
+  tt_parallel_worker(tp);
+  for (i = 0; i < tp->num_threads; i++) {
+    pthread_join(tp->threads[i], NULL);
+  }
+  pthread_mutex_lock(&tp->lock);
+  while (tp->busy > 0) {
+    pthread_cond_wait(&tp->cond, &tp->lock);
+  }
+  pthread_mutex_unlock(&tp->lock);
+  pthread_cond_destroy(&tp->cond);
+  pthread_mutex_destroy(&tp->lock);
+
+#ifdef POSIX_FADV_DONTNEED
+  /* The read-ahead of one thread may reach into subtrees already done */
+  if (tp->nocache) {
+    posix_fadvise(tp->fd, tp->offset, tp->size, POSIX_FADV_DONTNEED);
+  }
+#endif /* POSIX_FADV_DONTNEED */
+
+  error = tp->error;
+  if (0 == error) {
+    tt_combine(tp->roots, tp->n, hash);
+  }
+
+  free(tp->roots);
+  free(tp->threads);
+  free(tp);
+
+  if (error) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @return the number of bytes per subtree; all but the last subtree are
+ * this long.
+ */
+uint64_t
+tt_parallel_chunk(const struct tt_parallel *tp)
+{
+  return tp->chunk;
+}
+
+/*
+ * With jobs == 1, no threads are started and the subtrees can be shared
+ * out differently: the caller claims them one after another from the
+ * front with tt_parallel_claim() and hashes them together with whatever
+ * else it calculates over the file, while idle threads steal subtrees
+ * from the back with tt_parallel_steal(). Both meet somewhere in between,
+ * so each byte is hashed for the TTH once, and the threads are kept busy
+ * only if they have nothing else to do.
+ */
+
+/**
+ * Claims subtree "i" for the caller, who must claim them in order and
+ * store each root with tt_parallel_root().
+ *
+ * @return true if "i" was claimed, false if it has been stolen.
+ */
+bool
+tt_parallel_claim(struct tt_parallel *tp, size_t i)
+{
+  bool claimed;
+
+  pthread_mutex_lock(&tp->lock);
+  claimed = i < tp->back;
+  if (claimed) {
+    RUNTIME_ASSERT(i == tp->next);
+    tp->next++;
+  }
+  pthread_mutex_unlock(&tp->lock);
+  return claimed;
+}
+
+void
+tt_parallel_root(struct tt_parallel *tp, size_t i, const char root[TIGERSIZE])
+{
+  RUNTIME_ASSERT(i < tp->n);
+  memcpy(tp->roots[i], root, TIGERSIZE);
+}
+
+/**
+ * Takes the last subtree which nobody has claimed yet. It must be hashed
+ * with tt_parallel_stolen() before tt_parallel_finish() can return.
+ *
+ * @return true if a subtree was taken, false if there is none left.
+ */
+bool
+tt_parallel_steal(struct tt_parallel *tp, size_t *i)
+{
+  bool stolen;
+
+  pthread_mutex_lock(&tp->lock);
+  stolen = 0 == tp->error && tp->next < tp->back;
+  if (stolen) {
+    *i = --tp->back;
+    tp->busy++;
+  }
+  pthread_mutex_unlock(&tp->lock);
+  return stolen;
+}
+
+/**
+ * Hashes subtree "i" taken by tt_parallel_steal(). A failure is reported
+ * by tt_parallel_finish().
+ */
+void
+tt_parallel_stolen(struct tt_parallel *tp, size_t i)
+{
+  char (*leaves)[TIGERSIZE];
+  char *buf;
+  int error = 0;
+
+  buf = malloc(TT_PARALLEL_BUFSIZE);
+  leaves = calloc(tp->chunk / TTH_BLOCKSIZE, sizeof leaves[0]);
+  if (!buf || !leaves || tt_parallel_hash(tp, i, buf, leaves)) {
+    error = errno;
+  }
+  free(leaves);
+  free(buf);
+
+  pthread_mutex_lock(&tp->lock);
+  if (error && 0 == tp->error) {
+    tp->error = error;
+  }
+  tp->busy--;
+  pthread_cond_broadcast(&tp->cond);
+  pthread_mutex_unlock(&tp->lock);
+}
+
+/*
+ * Input of unknown length, such as a pipe, is collected by the reader in
+ * a ring of TT_PARALLEL_CHUNK buffers. Each full buffer is one subtree
+ * which is hashed by a pool of threads. The reader appends the subtree
+ * roots to a TT_CONTEXT strictly in order and recycles the buffers.
+ */
+
+enum tt_slot_state {
+  TT_SLOT_FREE,                 /* owned by the reader */
+  TT_SLOT_FULL,                 /* waiting for a thread */
+  TT_SLOT_BUSY,                 /* being hashed */
+  TT_SLOT_DONE                  /* root is ready to be merged */
+};
+
+struct tt_slot {
+  enum tt_slot_state state;
+  char *data;
+  size_t len;
+  char root[TIGERSIZE];
+};
+
+struct tt_stream {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;          /* signaled on every state change */
+  pthread_t *threads;
+  unsigned num_threads;
+  struct tt_slot *slots;        /* ring, two per thread */
+  unsigned num_slots;
+  uint64_t filled;              /* number of subtrees submitted */
+  uint64_t taken;               /* number of subtrees taken by threads */
+  uint64_t merged;              /* number of subtree roots merged */
+  bool eof;                     /* no more subtrees will be submitted */
+  size_t fill;                  /* bytes in the current buffer */
+  TT_CONTEXT ctx;               /* tree over the subtree roots */
+};
+
+static inline struct tt_slot *
+tt_stream_slot(struct tt_stream *ts, uint64_t seq)
+{
+  return &ts->slots[seq % ts->num_slots];
+}
+
+static void *
+tt_stream_worker(void *arg)
+{
+  struct tt_stream *ts = arg;
+
+  pthread_mutex_lock(&ts->lock);
+  for (;;) {
+    char leaves[TT_PARALLEL_CHUNK / TTH_BLOCKSIZE][TIGERSIZE];
+    struct tt_slot *slot;
+    size_t n;
+
+    if (ts->taken == ts->filled) {
+      if (ts->eof)
+        break;
+      pthread_cond_wait(&ts->cond, &ts->lock);
+      continue;
+    }
+
+    slot = tt_stream_slot(ts, ts->taken++);
+    RUNTIME_ASSERT(TT_SLOT_FULL == slot->state);
+    slot->state = TT_SLOT_BUSY;
+    pthread_mutex_unlock(&ts->lock);
+
+    n = tt_leaves(slot->data, slot->len, leaves);
+    tt_combine(leaves, n, slot->root);
+
+    pthread_mutex_lock(&ts->lock);
+    slot->state = TT_SLOT_DONE;
+    pthread_cond_broadcast(&ts->cond);
+  }
+  pthread_mutex_unlock(&ts->lock);
+  return NULL;
+}
+
+/* merge the roots which are done in order; called with the lock held */
+static void
+tt_stream_merge(struct tt_stream *ts)
+{
+  while (ts->merged < ts->filled) {
+    struct tt_slot *slot = tt_stream_slot(ts, ts->merged);
+
+    if (TT_SLOT_DONE != slot->state)
+      break;
+    tt_subtree(&ts->ctx, slot->root);
+    slot->state = TT_SLOT_FREE;
+    ts->merged++;
+  }
+}
+
+static void
+tt_stream_submit(struct tt_stream *ts)
+{
+  struct tt_slot *slot = tt_stream_slot(ts, ts->filled);
+
+  pthread_mutex_lock(&ts->lock);
+  slot->len = ts->fill;
+  slot->state = TT_SLOT_FULL;
+  ts->filled++;
+  ts->fill = 0;
+  pthread_cond_broadcast(&ts->cond);
+  pthread_mutex_unlock(&ts->lock);
+}
+
+static void
+tt_stream_free(struct tt_stream *ts)
+{
+  unsigned i;
+
+  if (ts->slots) {
+    for (i = 0; i < ts->num_slots; i++) {
+      free(ts->slots[i].data);
+    }
+  }
+  free(ts->slots);
+  free(ts->threads);
+  free(ts);
+}
+
+/**
+ * Starts "jobs" threads to hash the TTH of a stream. The caller reads
+ * the input into the buffers returned by tt_stream_space().
+ *
+ * @return NULL on failure.
+ */
+struct tt_stream *
+tt_stream_new(unsigned jobs)
+{
+  struct tt_stream *ts;
+  unsigned i;
+
+  RUNTIME_ASSERT(jobs > 0);
+
+  ts = calloc(1, sizeof *ts);
+  if (!ts)
+    return NULL;
+
+  ts->num_slots = 2 * jobs;
+  ts->slots = calloc(ts->num_slots, sizeof ts->slots[0]);
+  ts->threads = calloc(jobs, sizeof ts->threads[0]);
+  if (!ts->slots || !ts->threads) {
+    tt_stream_free(ts);
+    return NULL;
+  }
+  for (i = 0; i < ts->num_slots; i++) {
+    ts->slots[i].data = malloc(TT_PARALLEL_CHUNK);
+    if (!ts->slots[i].data) {
+      tt_stream_free(ts);
+      return NULL;
+    }
+  }
+
+  tt_init(&ts->ctx);
+  pthread_mutex_init(&ts->lock, NULL);
+  pthread_cond_init(&ts->cond, NULL);
+  for (i = 0; i < jobs; i++) {
+    if (pthread_create(&ts->threads[ts->num_threads], NULL,
+          tt_stream_worker, ts))
+      break;
+    ts->num_threads++;
+  }
+  if (0 == ts->num_threads) {
+    pthread_cond_destroy(&ts->cond);
+    pthread_mutex_destroy(&ts->lock);
+    tt_stream_free(ts);
+    return NULL;
+  }
+  return ts;
+}
+
+/**
+ * Waits until the next buffer is free if necessary, merging finished
+ * subtrees meanwhile.
+ *
+ * @return the free space of the current buffer and its size in "size".
+ */
+char *
+tt_stream_space(struct tt_stream *ts, size_t *size)
+{
+  struct tt_slot *slot = tt_stream_slot(ts, ts->filled);
+
+  if (0 == ts->fill) {
+    pthread_mutex_lock(&ts->lock);
+    for (;;) {
+      tt_stream_merge(ts);
+      if (TT_SLOT_FREE == slot->state)
+        break;
+      pthread_cond_wait(&ts->cond, &ts->lock);
+    }
+    pthread_mutex_unlock(&ts->lock);
+  }
+
+  *size = TT_PARALLEL_CHUNK - ts->fill;
+  return &slot->data[ts->fill];
+}
+
+/**
+ * Appends "n" bytes which were stored at tt_stream_space() to the input.
+ */
+void
+tt_stream_commit(struct tt_stream *ts, size_t n)
+{
+  RUNTIME_ASSERT(n <= TT_PARALLEL_CHUNK - ts->fill);
+
+  ts->fill += n;
+  if (TT_PARALLEL_CHUNK == ts->fill) {
+    tt_stream_submit(ts);
+  }
+}
+
+/**
+ * Submits the last subtree, waits for the threads and calculates the
+ * root. "ts" is freed.
+ */
+void
+tt_stream_digest(struct tt_stream *ts, char hash[TIGERSIZE])
+{
+  unsigned i;
+
+  /* The first buffer is free, so an empty input needs no waiting */
+  if (ts->fill > 0 || 0 == ts->filled) {
+    tt_stream_submit(ts);
+  }
+
+  pthread_mutex_lock(&ts->lock);
+  ts->eof = true;
+  pthread_cond_broadcast(&ts->cond);
+  while (ts->merged < ts->filled) {
+    tt_stream_merge(ts);
+    if (ts->merged < ts->filled) {
+      pthread_cond_wait(&ts->cond, &ts->lock);
+    }
+  }
+  pthread_mutex_unlock(&ts->lock);
+
+  for (i = 0; i < ts->num_threads; i++) {
+    pthread_join(ts->threads[i], NULL);
+  }
+  pthread_cond_destroy(&ts->cond);
+  pthread_mutex_destroy(&ts->lock);
+
+  tt_digest(&ts->ctx, hash);
+  tt_stream_free(ts);
+}
+
+#else /* !HAVE_PTHREAD_SUPPORT */
+
+struct tt_parallel *
+tt_parallel_file(int fd, uint64_t offset, uint64_t size, unsigned jobs,
+    bool nocache)
+{
+  (void) fd;
+  (void) offset;
+  (void) size;
+  (void) jobs;
+  (void) nocache;
+  errno = ENOSYS;
+  return NULL;
+}
+
+int
+tt_parallel_finish(struct tt_parallel *tp, char hash[TIGERSIZE])
+{
+  (void) tp;
+  (void) hash;
+  errno = ENOSYS;
+  return -1;
+}
+
+uint64_t
+tt_parallel_chunk(const struct tt_parallel *tp)
+{
+  (void) tp;
+  return TT_PARALLEL_CHUNK;
+}
+
+bool
+tt_parallel_claim(struct tt_parallel *tp, size_t i)
+{
+  (void) tp;
+  (void) i;
+  return false;
+}
+
+void
+tt_parallel_root(struct tt_parallel *tp, size_t i, const char root[TIGERSIZE])
+{
+  (void) tp;
+  (void) i;
+  (void) root;
+}
+
+bool
+tt_parallel_steal(struct tt_parallel *tp, size_t *i)
+{
+  (void) tp;
+  (void) i;
+  return false;
+}
+
+void
+tt_parallel_stolen(struct tt_parallel *tp, size_t i)
+{
+  (void) tp;
+  (void) i;
+}
+
+struct tt_stream *
+tt_stream_new(unsigned jobs)
+{
+  (void) jobs;
+  errno = ENOSYS;
+  return NULL;
+}
+
+char *
+tt_stream_space(struct tt_stream *ts, size_t *size)
+{
+  (void) ts;
+  *size = 0;
+  return NULL;
+}
+
+void
+tt_stream_commit(struct tt_stream *ts, size_t n)
+{
+  (void) ts;
+  (void) n;
+}
+
+void
+tt_stream_digest(struct tt_stream *ts, char hash[TIGERSIZE])
+{
+  (void) ts;
+  (void) hash;
+}
+
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+/* read buffer of each thread verifying segments */
+#define TT_VERIFY_BUFSIZE       (256 * 1024)
+
+/* each thread claims runs of consecutive segments of at least this size */
+#define TT_VERIFY_RUN           TT_PARALLEL_CHUNK
+
+struct tt_verify {
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_t lock;
+#endif /* HAVE_PTHREAD_SUPPORT */
+  int fd;
+  uint64_t size;                /* length of the file */
+  uint64_t segment;             /* bytes per segment, a power of two */
+  const char (*nodes)[TIGERSIZE]; /* expected root of each segment */
+  unsigned char *state;         /* enum tt_segment of each segment */
+  size_t next;                  /* next segment to check; under lock */
+  size_t end;                   /* segments from here on are not asked for */
+  size_t run;                   /* segments claimed at once */
+  bool stop;                    /* no more segments after a bad one */
+  bool bad;                     /* a bad segment was found; under lock */
+  int error;                    /* errno of the first failure; under lock */
+};
+
+static void
+tt_verify_lock(struct tt_verify *tv)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_lock(&tv->lock);
+#else
+  (void) tv;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+static void
+tt_verify_unlock(struct tt_verify *tv)
+{
+#ifdef HAVE_PTHREAD_SUPPORT
+  pthread_mutex_unlock(&tv->lock);
+#else
+  (void) tv;
+#endif /* HAVE_PTHREAD_SUPPORT */
+}
+
+/* the segments of a run, hashed as one stream */
+struct tt_verify_run {
+  struct tt_verify *tv;
+  size_t next;                  /* segment of the next root reported */
+  bool stop;                    /* "stop" and a bad segment was found */
+};
+
+/* compares the root of the next segment of the run with the tree */
+static void
+tt_verify_root(const char root[TIGERSIZE], void *udata)
+{
+  struct tt_verify_run *run = udata;
+  struct tt_verify *tv = run->tv;
+  size_t i = run->next++;
+
+  if (run->stop)
+    return;
+
+  /* Each thread sets the state of its own segments only */
+  if (0 == memcmp(root, tv->nodes[i], TIGERSIZE)) {
+    tv->state[i] = TT_SEGMENT_OK;
+  } else {
+    tv->state[i] = TT_SEGMENT_BAD;
+    tt_verify_lock(tv);
+    tv->bad = true;
+    tt_verify_unlock(tv);
+    run->stop = tv->stop;
+  }
+}
+
+/*
+ * Hashes the segments "first" up to "end" in one go. Each segment is an
+ * aligned subtree, so its root is reported by the context as a node
+ * "level" levels above the leaves, or by tt_digest() for the incomplete
+ * last segment of the file.
+ */
+static int
+tt_verify_hash(struct tt_verify *tv, size_t first, size_t end,
+    unsigned level, char *buf)
+{
+  struct tt_verify_run run;
+  char root[TIGERSIZE];
+  uint64_t pos, stop;
+  TT_CONTEXT ctx;
+
+  run.tv = tv;
+  run.next = first;
+  run.stop = false;
+  tt_init_callback(&ctx, NULL, tt_verify_root, level, &run);
+
+  pos = first * tv->segment;
+  stop = MIN(tv->size, end * tv->segment);
+  while (pos < stop) {
+    ssize_t ret;
+
+    ret = pread(tv->fd, buf, MIN(stop - pos, TT_VERIFY_BUFSIZE), pos);
+    if ((ssize_t) -1 == ret) {
+      if (EINTR == errno || EAGAIN == errno)
+        continue;
+      return -1;
+    } else if (0 == ret) {
+      errno = EIO; /* the file was truncated meanwhile */
+      return -1;
+    }
+    tt_update(&ctx, buf, (size_t) ret);
+    pos += (size_t) ret;
+    if (run.stop)
+      return 0;
+  }
+  tt_digest(&ctx, root);
+  RUNTIME_ASSERT(run.stop || run.next == end);
+  return 0;
+}
+
+static void *
+tt_verify_worker(void *arg)
+{
+  struct tt_verify *tv = arg;
+  unsigned level = 0;
+  char *buf;
+
+  buf = malloc(TT_VERIFY_BUFSIZE);
+  if (!buf) {
+    tt_verify_lock(tv);
+    tv->error = tv->error ? tv->error : errno;
+    tt_verify_unlock(tv);
+    return NULL;
+  }
+
+  while (((uint64_t) TTH_BLOCKSIZE << level) < tv->segment) {
+    level++;
+  }
+
+  for (;;) {
+    size_t first, end;
+
+    tt_verify_lock(tv);
+    first = 0 == tv->error && !(tv->stop && tv->bad) ? tv->next : tv->end;
+    end = MIN(tv->end, first + tv->run);
+    tv->next = end;
+    tt_verify_unlock(tv);
+
+    if (first >= end)
+      break;
+
+    if (tt_verify_hash(tv, first, end, level, buf)) {
+      tt_verify_lock(tv);
+      tv->error = tv->error ? tv->error : errno;
+      tt_verify_unlock(tv);
+      break;
+    }
+  }
+
+  free(buf);
+  return NULL;
+}
+
+/**
+ * Verifies the segments "first" up to "end" of the file "fd" of "size"
+ * bytes against "nodes", the expected root of each segment, with up to
+ * "jobs" threads including the calling one. Each segment consists of
+ * "segment" bytes, a multiple of TTH_BLOCKSIZE and a power of two, except
+ * for the last one, so "nodes" is a level of the THEX tree of the file.
+ * Only the segments asked for are read, in runs of consecutive ones which
+ * are hashed as one stream. The result of each segment is stored in
+ * "state", see enum tt_segment. With "stop", no further segments are
+ * started once a bad one is found, so some may be left unchecked.
+ *
+ * @return 0 on success, -1 on failure with errno set.
+ */
+int
+tt_parallel_verify(int fd, uint64_t size, uint64_t segment,
+    const char (*nodes)[TIGERSIZE], size_t first, size_t end,
+    unsigned jobs, bool stop, unsigned char *state)
+{
+  struct tt_verify tv;
+
+  RUNTIME_ASSERT(jobs > 0);
+  RUNTIME_ASSERT(segment >= TTH_BLOCKSIZE);
+  RUNTIME_ASSERT(0 == (segment & (segment - 1)));
+  RUNTIME_ASSERT(first <= end);
+
+  memset(&tv, 0, sizeof tv);
+  tv.fd = fd;
+  tv.size = size;
+  tv.segment = segment;
+  tv.nodes = nodes;
+  tv.state = state;
+  tv.next = first;
+  tv.end = end;
+  tv.run = MAX(1, TT_VERIFY_RUN / segment);
+  tv.stop = stop;
+  memset(&state[first], TT_SEGMENT_UNCHECKED, end - first);
+
+#ifdef HAVE_PTHREAD_SUPPORT
+  {
+    pthread_t *threads;
+    unsigned i, n = 0;
+
+    /* Without the threads, the calling thread does all the work */
+    jobs = MAX(1, MIN(jobs, (end - first + tv.run - 1) / tv.run));
+    threads = calloc(jobs, sizeof threads[0]);
+    pthread_mutex_init(&tv.lock, NULL);
+    for (i = 1; threads && i < jobs; i++) {
+      if (pthread_create(&threads[n], NULL, tt_verify_worker, &tv))
+        break;
+      n++;
+    }
+    tt_verify_worker(&tv);
+    for (i = 0; i < n; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&tv.lock);
+    free(threads);
+  }
+#else
+  (void) jobs;
+  tt_verify_worker(&tv);
+#endif /* HAVE_PTHREAD_SUPPORT */
+
+  if (tv.error) {
+    errno = tv.error;
+    return -1;
+  }
+  return 0;
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
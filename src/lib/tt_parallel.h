@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef TT_PARALLEL_HEADER_FILE
+#define TT_PARALLEL_HEADER_FILE
+
+#include "tigertree.h"
+
+/*
+ * The TTH of a large input is calculated by hashing aligned subtrees of
+ * at least TT_PARALLEL_CHUNK bytes (1024 leaves) on several threads and
+ * combining their roots with tt_combine() at the end.
+ */
+#define TT_PARALLEL_CHUNK (1024 * TTH_BLOCKSIZE)
+
+struct tt_parallel;
+struct tt_stream;
+
+/* The result of tt_parallel_verify() for each segment */
+enum tt_segment {
+  TT_SEGMENT_UNCHECKED = 0,
+  TT_SEGMENT_OK,
+  TT_SEGMENT_BAD
+};
+
+struct tt_parallel *tt_parallel_file(int fd, uint64_t offset, uint64_t size,
+    unsigned jobs, bool nocache);
+int tt_parallel_finish(struct tt_parallel *tp, char hash[TIGERSIZE]);
+uint64_t tt_parallel_chunk(const struct tt_parallel *tp);
+bool tt_parallel_claim(struct tt_parallel *tp, size_t i);
+void tt_parallel_root(struct tt_parallel *tp, size_t i,
+    const char root[TIGERSIZE]);
+bool tt_parallel_steal(struct tt_parallel *tp, size_t *i);
+void tt_parallel_stolen(struct tt_parallel *tp, size_t i);
+
+struct tt_stream *tt_stream_new(unsigned jobs);
+char *tt_stream_space(struct tt_stream *ts, size_t *size);
+void tt_stream_commit(struct tt_stream *ts, size_t n);
+void tt_stream_digest(struct tt_stream *ts, char hash[TIGERSIZE]);
+
+int tt_parallel_verify(int fd, uint64_t size, uint64_t segment,
+    const char (*nodes)[TIGERSIZE], size_t first, size_t end,
+    unsigned jobs, bool stop, unsigned char *state);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* TT_PARALLEL_HEADER_FILE */
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uring.h"
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+struct uring {
+  int fd;
+  unsigned depth;
+  unsigned unsubmitted;         /* SQEs queued since the last enter */
+
+  /* Submission queue */
+  unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+  struct io_uring_sqe *sqes;
+  unsigned sq_entries;
+
+  /* Completion queue */
+  unsigned *cq_head, *cq_tail, *cq_mask;
+  struct io_uring_cqe *cqes;
+
+  void *sq_ring, *cq_ring;
+  size_t sq_ring_size, cq_ring_size, sqes_size;
+
+  struct iovec iov[2];          /* registered buffers */
+  unsigned iovcnt;
+  char *slots;
+};
+
+static int
+uring_setup(unsigned entries, struct io_uring_params *p)
+{
+  return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int
+uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+  return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+      NULL, 0);
+}
+
+static int
+uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+  return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+#define URING_RING_PTR(ring, off) \
+  ((unsigned *) (void *) ((char *) (ring) + (off)))
+
+/**
+ * Releases all resources of the ring. No reads may be in flight.
+ */
+void
+uring_free(struct uring *ur)
+{
+  if (ur) {
+    if (ur->sqes) {
+      munmap(ur->sqes, ur->sqes_size);
+    }
+    if (ur->cq_ring && ur->cq_ring != ur->sq_ring) {
+      munmap(ur->cq_ring, ur->cq_ring_size);
+    }
+    if (ur->sq_ring) {
+      munmap(ur->sq_ring, ur->sq_ring_size);
+    }
+    if (ur->fd >= 0) {
+      close(ur->fd);
+    }
+    if (ur->slots) {
+      compat_page_free(ur->slots, (size_t) ur->depth * URING_BLOCK);
+    }
+    free(ur);
+  }
+}
+
+/**
+ * Sets up a ring for up to "depth" reads in flight and registers its
+ * slots and the buffer "buf" of "size" bytes, unless NULL, with the
+ * kernel.
+ *
+ * @return NULL if io_uring is not available; otherwise the new ring.
+ */
+struct uring *
+uring_new(unsigned depth, void *buf, size_t size)
+{
+  struct io_uring_params p;
+  struct uring *ur;
+  void *ring;
+
+  RUNTIME_ASSERT(depth > 0 && depth <= URING_DEPTH_MAX);
+
+  ur = calloc(1, sizeof *ur);
+  if (!ur)
+    return NULL;
+
+  ur->fd = -1;
+  ur->depth = depth;
+  memset(&p, 0, sizeof p);
+  ur->fd = uring_setup(depth, &p);
+  if (ur->fd < 0)
+    goto failure;
+
+  ur->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  ur->cq_ring_size = p.cq_off.cqes +
+    p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    ur->sq_ring_size = MAX(ur->sq_ring_size, ur->cq_ring_size);
+    ur->cq_ring_size = ur->sq_ring_size;
+  }
+
+  ring = mmap(NULL, ur->sq_ring_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_SQ_RING);
+  if (MAP_FAILED == ring)
+    goto failure;
+  ur->sq_ring = ring;
+
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    ur->cq_ring = ur->sq_ring;
+  } else {
+    ring = mmap(NULL, ur->cq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_CQ_RING);
+    if (MAP_FAILED == ring)
+      goto failure;
+    ur->cq_ring = ring;
+  }
+
+  ur->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  ring = mmap(NULL, ur->sqes_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ur->fd, IORING_OFF_SQES);
+  if (MAP_FAILED == ring)
+    goto failure;
+  ur->sqes = ring;
+
+  ur->sq_head = URING_RING_PTR(ur->sq_ring, p.sq_off.head);
+  ur->sq_tail = URING_RING_PTR(ur->sq_ring, p.sq_off.tail);
+  ur->sq_mask = URING_RING_PTR(ur->sq_ring, p.sq_off.ring_mask);
+  ur->sq_array = URING_RING_PTR(ur->sq_ring, p.sq_off.array);
+  ur->sq_entries = p.sq_entries;
+  ur->cq_head = URING_RING_PTR(ur->cq_ring, p.cq_off.head);
+  ur->cq_tail = URING_RING_PTR(ur->cq_ring, p.cq_off.tail);
+  ur->cq_mask = URING_RING_PTR(ur->cq_ring, p.cq_off.ring_mask);
+  ur->cqes = (void *) ((char *) ur->cq_ring + p.cq_off.cqes);
+
+  /*
+   * Fixed buffers save mapping the pages of every read anew. The slots
+   * are page-aligned so that they can be used with O_DIRECT.
+   */
+  ur->slots = compat_page_align((size_t) depth * URING_BLOCK);
+  if (!ur->slots)
+    goto failure;
+  ur->iov[ur->iovcnt].iov_base = ur->slots;
+  ur->iov[ur->iovcnt].iov_len = (size_t) depth * URING_BLOCK;
+  ur->iovcnt++;
+  if (buf) {
+    ur->iov[ur->iovcnt].iov_base = buf;
+    ur->iov[ur->iovcnt].iov_len = size;
+    ur->iovcnt++;
+  }
+  if (uring_register(ur->fd, IORING_REGISTER_BUFFERS, ur->iov, ur->iovcnt))
+    goto failure;
+
+  return ur;
+
+failure:
+  uring_free(ur);
+  return NULL;
+}
+
+unsigned
+uring_depth(const struct uring *ur)
+{
+  return ur->depth;
+}
+
+/**
+ * @return the i-th of the registered slots of URING_BLOCK bytes.
+ */
+char *
+uring_slot(struct uring *ur, unsigned i)
+{
+  RUNTIME_ASSERT(i < ur->depth);
+  return &ur->slots[(size_t) i * URING_BLOCK];
+}
+
+static int
+uring_submit(struct uring *ur, unsigned min_complete)
+{
+  for (;;) {
+    int ret;
+
+    ret = uring_enter(ur->fd, ur->unsubmitted, min_complete,
+        min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (ret >= 0) {
+      ur->unsubmitted -= MIN((unsigned) ret, ur->unsubmitted);
+      return 0;
+    }
+    if (EINTR != errno && EAGAIN != errno && EBUSY != errno)
+      return -1;
+  }
+}
+
+/**
+ * Queues a read of "size" bytes at "offset" of "fd" into "buf", which
+ * must lie within one of the registered buffers. The read is passed to
+ * the kernel by the next uring_wait() at the latest. The caller must not
+ * have more than the depth of the ring in flight.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int
+uring_read(struct uring *ur, int fd, void *buf, size_t size,
+    uint64_t offset, uint64_t tag)
+{
+  struct io_uring_sqe *sqe;
+  unsigned i, tail;
+
+  for (i = 0; i < ur->iovcnt; i++) {
+    const char *base = ur->iov[i].iov_base, *p = buf;
+
+    if (p >= base && p + size <= base + ur->iov[i].iov_len)
+      break;
+  }
+  RUNTIME_ASSERT(i < ur->iovcnt);
+
+  tail = *ur->sq_tail;
+  if (tail - __atomic_load_n(ur->sq_head, __ATOMIC_ACQUIRE) >= ur->sq_entries) {
+    if (uring_submit(ur, 0))
+      return -1;
+  }
+
+  sqe = &ur->sqes[tail & *ur->sq_mask];
+  memset(sqe, 0, sizeof *sqe);
+  sqe->opcode = IORING_OP_READ_FIXED;
+  sqe->fd = fd;
+  sqe->off = offset;
+  sqe->addr = PTR2UINT(buf);
+  sqe->len = size;
+  sqe->buf_index = i;
+  sqe->user_data = tag;
+  ur->sq_array[tail & *ur->sq_mask] = tail & *ur->sq_mask;
+  __atomic_store_n(ur->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ur->unsubmitted++;
+  return 0;
+}
+
+/**
+ * Submits all queued reads and waits until one of the reads is complete.
+ * "res" is set to the number of bytes read or a negative errno value,
+ * "tag" to the tag given to uring_read().
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int
+uring_wait(struct uring *ur, uint64_t *tag, int *res)
+{
+  for (;;) {
+    unsigned head = *ur->cq_head;
+
+    if (head != __atomic_load_n(ur->cq_tail, __ATOMIC_ACQUIRE)) {
+      const struct io_uring_cqe *cqe = &ur->cqes[head & *ur->cq_mask];
+
+      *tag = cqe->user_data;
+      *res = cqe->res;
+      __atomic_store_n(ur->cq_head, head + 1, __ATOMIC_RELEASE);
+      return 0;
+    }
+    if (uring_submit(ur, 1))
+      return -1;
+  }
+}
+
+#else /* !HAVE_IO_URING */
+
+struct uring *
+uring_new(unsigned depth, void *buf, size_t size)
+{
+  (void) depth;
+  (void) buf;
+  (void) size;
+  errno = ENOSYS;
+  return NULL;
+}
+
+void
+uring_free(struct uring *ur)
+{
+  (void) ur;
+}
+
+unsigned
+uring_depth(const struct uring *ur)
+{
+  (void) ur;
+  return 0;
+}
+
+char *
+uring_slot(struct uring *ur, unsigned i)
+{
+  (void) ur;
+  (void) i;
+  return NULL;
+}
+
+int
+uring_read(struct uring *ur, int fd, void *buf, size_t size,
+    uint64_t offset, uint64_t tag)
+{
+  (void) ur;
+  (void) fd;
+  (void) buf;
+  (void) size;
+  (void) offset;
+  (void) tag;
+  errno = ENOSYS;
+  return -1;
+}
+
+int
+uring_wait(struct uring *ur, uint64_t *tag, int *res)
+{
+  (void) ur;
+  (void) tag;
+  (void) res;
+  errno = ENOSYS;
+  return -1;
+}
+
+#endif /* HAVE_IO_URING */
+
+/* vi: set ai et sts=2 sw=2 cindent: */
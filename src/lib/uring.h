@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef URING_HEADER_FILE
+#define URING_HEADER_FILE
+
+#include "common.h"
+
+/*
+ * A uring keeps up to "depth" reads in flight with io_uring so that the
+ * device is busy while the previous data is being hashed. All reads go to
+ * buffers registered with the kernel once: "depth" slots of URING_BLOCK
+ * bytes, see uring_slot(), and optionally one buffer of the caller.
+ */
+#define URING_DEPTH_DEFAULT 8
+#define URING_DEPTH_MAX     64
+#define URING_BLOCK         (128 * 1024)
+
+struct uring;
+
+struct uring *uring_new(unsigned depth, void *buf, size_t size);
+void uring_free(struct uring *ur);
+unsigned uring_depth(const struct uring *ur);
+char *uring_slot(struct uring *ur, unsigned i);
+int uring_read(struct uring *ur, int fd, void *buf, size_t size,
+    uint64_t offset, uint64_t tag);
+int uring_wait(struct uring *ur, uint64_t *tag, int *res);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* URING_HEADER_FILE */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#include "verify.h"
+#include "base32.h"
+#include "debug.h"
+#include "nettools.h"
+#include "tiger.h"
+
+/**
+ * Reads all of "path", or the standard input for "-", into an allocated
+ * NUL-terminated buffer.
+ *
+ * @return NULL on failure with errno set.
+ */
+static char *
+read_all(const char *path)
+{
+  size_t size = 64 * 1024, len = 0;
+  char *buf = NULL;
+  int fd;
+
+  fd = strcmp(path, "-") ? open(path, O_RDONLY, 0) : STDIN_FILENO;
+  if (fd < 0)
+    return NULL;
+
+  for (;;) {
+    ssize_t ret;
+
+    if (!buf || len + 1 == size) {
+      char *p = realloc(buf, buf ? size *= 2 : size);
+
+      if (!p)
+        break;
+      buf = p;
+    }
+    ret = read(fd, &buf[len], size - 1 - len);
+    if (0 == ret) {
+      buf[len] = '\0';
+      if (STDIN_FILENO != fd) {
+        close(fd);
+      }
+      return buf;
+    } else if ((ssize_t) -1 != ret) {
+      len += (size_t) ret;
+    } else if (EINTR != errno && EAGAIN != errno) {
+      break;
+    }
+  }
+
+  {
+    int error = errno;
+
+    free(buf);
+    if (STDIN_FILENO != fd) {
+      close(fd);
+    }
+    errno = error;
+  }
+  return NULL;
+}
+
+/**
+ * Finds the first THEX tree in "text", a line "thex:LEVELS:BASE32" as
+ * printed with -X, possibly after the name of the file, and decodes it
+ * in place.
+ *
+ * @return the nodes of the tree, NULL if there is none.
+ */
+static const char *
+thex_parse(char *text, size_t *n, unsigned *levels)
+{
+  char *line, *next;
+
+  for (line = text; line; line = next) {
+    char *s, *end;
+    size_t len, chars, size;
+    uint32_t u;
+    int error;
+
+    next = strchr(line, '\n');
+    if (next) {
+      *next++ = '\0';
+    }
+    s = strstr(line, "thex:");
+    if (!s || (s != line && (s - line < 2 || 0 != memcmp(&s[-2], ": ", 2))))
+      continue;
+
+    u = parse_uint32(&s[5], &end, 10, &error);
+    if (error || ':' != *end || u < 1 || u > TT_THEX_DEPTH_MAX)
+      continue;
+
+    s = &end[1];
+    len = strlen(s);
+    while (len > 0 && isspace((unsigned char) s[len - 1])) {
+      len--;
+    }
+    if (0 == len || 0 != len % 8)
+      continue;
+
+    /* base32_decode() accepts less padding, so use zero digits instead */
+    for (chars = len; chars > 0 && '=' == s[chars - 1]; chars--) {
+      s[chars - 1] = 'A';
+    }
+    size = chars * 5 / 8;
+    if (
+      0 == size || 0 != size % TIGERSIZE ||
+      size != base32_decode(s, size, s, len)
+    ) {
+      continue;
+    }
+
+    *n = size / TIGERSIZE;
+    *levels = u;
+    return s;
+  }
+  return NULL;
+}
+
+/**
+ * Reads the THEX tree from the file "path", or from the standard input for
+ * "-", into "v".
+ *
+ * @return VERIFY_OK, VERIFY_ERRNO if "path" cannot be read or
+ * VERIFY_NO_TREE.
+ */
+enum verify_status
+verify_load(struct verify *v, const char *path)
+{
+  memset(v, 0, sizeof *v);
+  v->text = read_all(path);
+  if (!v->text)
+    return VERIFY_ERRNO;
+
+  v->tree = thex_parse(v->text, &v->n, &v->levels);
+  return v->tree ? VERIFY_OK : VERIFY_NO_TREE;
+}
+
+/**
+ * Checks that the tree loaded into "v" is that of a file of "size" bytes
+ * and that each of its levels follows from the one below. The segments
+ * are those of the bottom level.
+ *
+ * @return VERIFY_OK, VERIFY_MISMATCH or VERIFY_CORRUPT.
+ */
+enum verify_status
+verify_match(struct verify *v, uint64_t size)
+{
+  char (*scratch)[TIGERSIZE];
+  uint64_t leaves;
+  unsigned height, bottom;
+  size_t c, total;
+
+  /* The levels follow from the size, so the tree must match it */
+  leaves = MAX(1, size / TTH_BLOCKSIZE + (0 != size % TTH_BLOCKSIZE));
+  for (height = 0; ((uint64_t) 1 << height) < leaves; height++)
+    continue;
+  bottom = v->levels <= height + 1 ? height + 1 - v->levels : 0;
+  v->count = ((leaves - 1) >> bottom) + 1;
+  total = 0;
+  for (c = v->count; /* NOTHING */; c = (c + 1) / 2) {
+    total += c;
+    if (1 == c)
+      break;
+  }
+  if (total != v->n || v->levels > height + 1)
+    return VERIFY_MISMATCH;
+
+  v->size = size;
+  v->nodes = (const char (*)[TIGERSIZE]) &v->tree[(v->n - v->count) *
+    TIGERSIZE];
+  v->segment = (uint64_t) TTH_BLOCKSIZE << bottom;
+
+  scratch = malloc(v->count * sizeof scratch[0]);
+  v->state = calloc(v->count, 1);
+  if (!scratch || !v->state) {
+    print_error("malloc", NULL, errno);
+    exit(EXIT_FAILURE);
+  }
+  memcpy(scratch, v->nodes, v->count * sizeof scratch[0]);
+  total = v->n - v->count;
+  for (c = v->count; c > 1; c = (c + 1) / 2) {
+    tiger_multi_nodes(scratch, c / 2, scratch);
+    if (c & 1) {
+      memcpy(scratch[c / 2], scratch[c - 1], TIGERSIZE);
+    }
+    total -= (c + 1) / 2;
+    if (
+      0 != memcmp(scratch, &v->tree[total * TIGERSIZE],
+        (c + 1) / 2 * TIGERSIZE)
+    ) {
+      break;
+    }
+  }
+  free(scratch);
+  return c > 1 ? VERIFY_CORRUPT : VERIFY_OK;
+}
+
+/**
+ * Hashes the segments "first" up to "end" of "fd" on "jobs" threads and
+ * records the outcome of each in v->state. With "stop", no further
+ * segments are checked once one is corrupt.
+ *
+ * @return 0 on success, -1 on a read error with errno set.
+ */
+int
+verify_segments(struct verify *v, int fd, size_t first, size_t end,
+    unsigned jobs, bool stop)
+{
+  RUNTIME_ASSERT(first <= end && end <= v->count);
+  return tt_parallel_verify(fd, v->size, v->segment, v->nodes, first, end,
+    jobs, stop, v->state);
+}
+
+/**
+ * Frees the tree and the segment states of "v".
+ */
+void
+verify_free(struct verify *v)
+{
+  free(v->state);
+  free(v->text);
+  memset(v, 0, sizeof *v);
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
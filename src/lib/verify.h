@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+#ifndef VERIFY_HEADER_FILE
+#define VERIFY_HEADER_FILE
+
+#include "tt_parallel.h"
+
+/*
+ * Verifying a file against its THEX tree as printed with -X. Each node of
+ * the bottom level of the tree is the root of a segment of the file, so
+ * the segments can be checked one by one.
+ */
+
+enum verify_status {
+  VERIFY_OK = 0,
+  VERIFY_ERRNO,                 /* see errno */
+  VERIFY_NO_TREE,               /* there is no THEX tree in the text */
+  VERIFY_MISMATCH,              /* the tree is not that of a file this size */
+  VERIFY_CORRUPT                /* a level does not follow from the next */
+};
+
+struct verify {
+  char *text;                   /* the decoded tree is within it */
+  const char *tree;
+  size_t n;                     /* number of nodes in tree */
+  unsigned levels;
+  uint64_t size;                /* size of the file */
+  uint64_t count;               /* number of segments */
+  uint64_t segment;             /* size of a segment in bytes */
+  const char (*nodes)[TIGERSIZE];  /* the bottom level of tree */
+  unsigned char *state;         /* enum tt_segment of each segment */
+};
+
+enum verify_status verify_load(struct verify *v, const char *path);
+enum verify_status verify_match(struct verify *v, uint64_t size);
+int verify_segments(struct verify *v, int fd, size_t first, size_t end,
+    unsigned jobs, bool stop);
+void verify_free(struct verify *v);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* VERIFY_HEADER_FILE */
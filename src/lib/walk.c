@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "walk.h"
+
+#include <dirent.h>
+
+#ifdef HAVE_STATX
+#include <sys/sysmacros.h>
+#endif /* HAVE_STATX */
+
+/* a multiple of the largest entry getdents64() can return */
+#define WALK_BUFSIZE  (32 * 1024)
+
+struct walk_dir {
+  int fd;
+  bool follow;                  /* follow symbolic links */
+#ifdef HAVE_GETDENTS64
+  size_t pos, len;              /* current entry, end of the entries */
+  char buf[WALK_BUFSIZE];
+#else
+  DIR *dirp;
+#endif /* HAVE_GETDENTS64 */
+};
+
+/**
+ * Opens the directory "path" for walk_read(). With "follow", symbolic
+ * links in the directory are followed, else they are skipped.
+ *
+ * @return NULL on failure with errno set.
+ */
+struct walk_dir *
+walk_open(const char *path, bool follow)
+{
+  struct walk_dir *wd;
+  int flags = O_RDONLY;
+
+#ifdef O_DIRECTORY
+  flags |= O_DIRECTORY;
+#endif /* O_DIRECTORY */
+
+  wd = malloc(sizeof *wd);
+  if (!wd)
+    return NULL;
+
+  wd->follow = follow;
+  wd->fd = open(path, flags, 0);
+  if (wd->fd < 0) {
+    free(wd);
+    return NULL;
+  }
+
+#ifdef HAVE_GETDENTS64
+  wd->pos = 0;
+  wd->len = 0;
+#else
+  wd->dirp = fdopendir(wd->fd);
+  if (!wd->dirp) {
+    int error = errno;
+
+    close(wd->fd);
+    free(wd);
+    errno = error;
+    return NULL;
+  }
+#endif /* HAVE_GETDENTS64 */
+
+  return wd;
+}
+
+/*
+ * Looks up the type of "e" and whether it has several links. A failure is
+ * not reported here: the entry is passed on as a file so that opening it
+ * reports the problem, as with a dangling symbolic link.
+ */
+static void
+walk_stat(const struct walk_dir *wd, struct walk_entry *e)
+{
+  int flags = wd->follow ? 0 : AT_SYMLINK_NOFOLLOW;
+  uint64_t nlink;
+  mode_t mode;
+
+#ifdef HAVE_STATX
+  struct statx stx;
+
+  if (
+    statx(wd->fd, e->name, flags | AT_STATX_DONT_SYNC,
+      STATX_TYPE | STATX_INO | STATX_NLINK, &stx)
+  ) {
+    e->type = WALK_FILE;
+    return;
+  }
+  mode = stx.stx_mode;
+  nlink = stx.stx_nlink;
+  e->dev = makedev(stx.stx_dev_major, stx.stx_dev_minor); /* as st_dev */
+  e->ino = stx.stx_ino;
+#else
+  struct stat sb;
+
+  if (fstatat(wd->fd, e->name, &sb, flags)) {
+    e->type = WALK_FILE;
+    return;
+  }
+  mode = sb.st_mode;
+  nlink = sb.st_nlink;
+  e->dev = sb.st_dev;
+  e->ino = sb.st_ino;
+#endif /* HAVE_STATX */
+
+  if (S_ISREG(mode)) {
+    e->type = WALK_FILE;
+    e->linked = nlink > 1;
+  } else if (S_ISDIR(mode)) {
+    e->type = WALK_DIR;
+  } else {
+    e->type = WALK_OTHER;
+  }
+}
+
+/**
+ * Reads the next regular file or subdirectory of "wd". Anything else as
+ * well as "." and ".." are skipped.
+ *
+ * @return 1 if "e" was filled, 0 at the end of the directory and -1 on
+ * failure with errno set.
+ */
+int
+walk_read(struct walk_dir *wd, struct walk_entry *e)
+{
+  for (;;) {
+    const char *name;
+    unsigned char type = DT_UNKNOWN;
+
+#ifdef HAVE_GETDENTS64
+    const struct dirent64 *d;
+
+    if (wd->pos >= wd->len) {
+      ssize_t ret;
+
+      ret = getdents64(wd->fd, wd->buf, sizeof wd->buf);
+      if ((ssize_t) -1 == ret) {
+        if (EINTR == errno)
+          continue;
+        return -1;
+      } else if (0 == ret) {
+        return 0;
+      }
+      wd->pos = 0;
+      wd->len = ret;
+    }
+    d = (const void *) &wd->buf[wd->pos];
+    wd->pos += d->d_reclen;
+    name = d->d_name;
+    type = d->d_type;
+#else
+    const struct dirent *d;
+
+    errno = 0;
+    d = readdir(wd->dirp);
+    if (!d)
+      return errno ? -1 : 0;
+    name = d->d_name;
+#ifdef _DIRENT_HAVE_D_TYPE
+    type = d->d_type;
+#endif /* _DIRENT_HAVE_D_TYPE */
+#endif /* HAVE_GETDENTS64 */
+
+    if ('.' == name[0]) {
+      if ('\0' == name[1] || ('.' == name[1] && '\0' == name[2]))
+        continue;
+    }
+
+    e->name = name;
+    e->linked = false;
+    switch (type) {
+    case DT_DIR:
+      e->type = WALK_DIR;
+      return 1;
+    case DT_LNK:
+      if (!wd->follow)
+        continue;
+      break;
+    case DT_REG:
+    case DT_UNKNOWN:
+      break;
+    default:
+      continue;
+    }
+
+    /* Regular files are looked at for hard links */
+    walk_stat(wd, e);
+    if (WALK_OTHER != e->type)
+      return 1;
+  }
+}
+
+/**
+ * Gets the device and inode number of the directory itself.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int
+walk_id(const struct walk_dir *wd, uint64_t *dev, uint64_t *ino)
+{
+  struct stat sb;
+
+  if (fstat(wd->fd, &sb))
+    return -1;
+  *dev = sb.st_dev;
+  *ino = sb.st_ino;
+  return 0;
+}
+
+void
+walk_close(struct walk_dir *wd)
+{
+  if (wd) {
+#ifdef HAVE_GETDENTS64
+    close(wd->fd);
+#else
+    closedir(wd->dirp);
+#endif /* HAVE_GETDENTS64 */
+    free(wd);
+  }
+}
+
+/*
+ * A set of device and inode numbers, used to hash files with several
+ * links only once and, when following symbolic links, to enter each
+ * directory only once. Each inode carries the data it was added with.
+ * Open addressing with linear probing; the table is doubled when it is
+ * half full.
+ */
+
+struct inode_set {
+  struct inode_key {
+    uint64_t dev, ino;
+    void *data;                 /* NULL if the slot is unused */
+  } *keys;
+  size_t size;                  /* a power of two */
+  size_t n;
+};
+
+static inline size_t
+inode_set_slot(const struct inode_set *set, uint64_t dev, uint64_t ino)
+{
+  uint64_t h = (ino ^ (dev << 17)) * (uint64_t) 0x9e3779b97f4a7c15ULL;
+
+  return (h >> 32) & (set->size - 1);
+}
+
+static int
+inode_set_grow(struct inode_set *set)
+{
+  struct inode_key *old = set->keys;
+  size_t i, old_size = set->size;
+
+  set->keys = calloc(2 * old_size, sizeof set->keys[0]);
+  if (!set->keys) {
+    set->keys = old;
+    return -1;
+  }
+  set->size = 2 * old_size;
+  for (i = 0; i < old_size; i++) {
+    if (old[i].data) {
+      size_t j = inode_set_slot(set, old[i].dev, old[i].ino);
+
+      while (set->keys[j].data) {
+        j = (j + 1) & (set->size - 1);
+      }
+      set->keys[j] = old[i];
+    }
+  }
+  free(old);
+  return 0;
+}
+
+struct inode_set *
+inode_set_new(void)
+{
+  struct inode_set *set;
+
+  set = calloc(1, sizeof *set);
+  if (set) {
+    set->size = 256;
+    set->keys = calloc(set->size, sizeof set->keys[0]);
+    if (!set->keys) {
+      free(set);
+      set = NULL;
+    }
+  }
+  return set;
+}
+
+/**
+ * Adds an inode with the non-NULL "data" to the set unless it is there
+ * already. If memory runs out, the inode is not added and reported as
+ * new.
+ *
+ * @return the data of the inode if it was in the set, NULL if not.
+ */
+void *
+inode_set_add(struct inode_set *set, uint64_t dev, uint64_t ino, void *data)
+{
+  size_t i;
+
+  RUNTIME_ASSERT(data);
+  if (2 * (set->n + 1) > set->size && inode_set_grow(set))
+    return NULL;
+
+  i = inode_set_slot(set, dev, ino);
+  while (set->keys[i].data) {
+    if (set->keys[i].dev == dev && set->keys[i].ino == ino)
+      return set->keys[i].data;
+    i = (i + 1) & (set->size - 1);
+  }
+  set->keys[i].dev = dev;
+  set->keys[i].ino = ino;
+  set->keys[i].data = data;
+  set->n++;
+  return NULL;
+}
+
+void
+inode_set_free(struct inode_set *set)
+{
+  if (set) {
+    free(set->keys);
+    free(set);
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
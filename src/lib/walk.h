@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef WALK_HEADER_FILE
+#define WALK_HEADER_FILE
+
+#include "common.h"
+
+/*
+ * Reading directories for the recursive mode. The entries are read with
+ * getdents64() and examined with statx() relative to the directory, each
+ * at most once; the type reported by the directory spares the stat of
+ * subdirectories and symbolic links which are not followed.
+ */
+
+enum walk_type {
+  WALK_OTHER,                   /* anything to skip */
+  WALK_FILE,                    /* regular file */
+  WALK_DIR                      /* directory */
+};
+
+struct walk_entry {
+  const char *name;             /* valid until the next walk_read() */
+  enum walk_type type;
+  bool linked;                  /* a file with more than one link */
+  uint64_t dev, ino;            /* only set if "linked" */
+};
+
+struct walk_dir;
+struct inode_set;
+
+struct walk_dir *walk_open(const char *path, bool follow);
+int walk_read(struct walk_dir *wd, struct walk_entry *e);
+int walk_id(const struct walk_dir *wd, uint64_t *dev, uint64_t *ino);
+void walk_close(struct walk_dir *wd);
+
+struct inode_set *inode_set_new(void);
+void *inode_set_add(struct inode_set *set, uint64_t dev, uint64_t ino,
+    void *data);
+void inode_set_free(struct inode_set *set);
+
+/* vi: set ai et sts=2 sw=2 cindent: */
+#endif /* WALK_HEADER_FILE */
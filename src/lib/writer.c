@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 The bitter contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "writer.h"
+
+void
+writer_flush(struct writer *w)
+{
+  size_t done = 0;
+
+  while (done < w->fill) {
+    ssize_t ret;
+
+    ret = write(w->fd, &w->buf[done], w->fill - done);
+    if ((ssize_t) -1 != ret) {
+      done += ret;
+    } else if (EINTR != errno && EAGAIN != errno) {
+      print_error("write", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
+  w->fill = 0;
+}
+
+void
+writer_puts(struct writer *w, const char *s)
+{
+  size_t len = strlen(s);
+
+  while (len > 0) {
+    size_t n;
+
+    if (sizeof w->buf == w->fill) {
+      writer_flush(w);
+    }
+    n = MIN(len, sizeof w->buf - w->fill);
+    memcpy(&w->buf[w->fill], s, n);
+    w->fill += n;
+    s += n;
+    len -= n;
+  }
+}
+
+/* vi: set ai et sts=2 sw=2 cindent: */
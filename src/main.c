@@ -27,21 +27,27 @@
 
 #include "lib/common.h"
 #include "lib/tigertree.h"
-#include "lib/tiger.h"
 #include "lib/base16.h"
 #include "lib/base32.h"
-#include "lib/compat_sha1.h"
 #include "lib/nettools.h"
+#include "lib/kernel.h"
+#include "lib/uring.h"
+#include "lib/cpu.h"
+#include "lib/hashcache.h"
+#include "lib/hasher.h"
+#include "lib/pool.h"
+#include "lib/verify.h"
+#include "lib/writer.h"
+
+#ifdef HAVE_GETOPT_LONG
+#include <getopt.h>
+#endif /* HAVE_GETOPT_LONG */
 
 #define SHA1_BASE32_LEN 32
 #define SHA1_BASE16_LEN 40
 
 static const unsigned bitter_major_version = 1, bitter_minor_version = 3;
 
-struct tth {
-  char data[24 /* TIGERSIZE */];
-};
-
 static const char *
 sha1_to_base32(const struct sha1 *hash)
 {
@@ -93,149 +99,425 @@ tth_to_base32(const struct tth *hash)
   return s;
 }
 
-static void
-print_bitprint(FILE *f, const struct sha1 *sha1, const struct tth *tth)
+static const char *
+tiger_to_base32(const struct tiger_hash *hash)
 {
-  if (f && sha1 && tth) {
-    fputs("urn:bitprint:", f);
-    fputs(sha1_to_base32(sha1), f);
-    fputs(".", f);
-    fputs(tth_to_base32(tth), f);
+  const char *s;
+  
+  if (hash) {
+    static char buf[40];
+
+    s = buf;
+    base32_encode(buf, sizeof buf, hash->data, sizeof hash->data);
+    buf[ARRAY_LEN(buf) - 1] = '\0';
+  } else {
+    s = NULL;
   }
+  return s;
 }
 
+static struct writer output;
 
 static void
-print_sha1(FILE *f, const struct sha1 *sha1)
+print_bitprint(struct writer *w, const struct sha1 *sha1,
+    const struct tth *tth)
 {
-  if (f && sha1) {
-    fputs("urn:sha1:", f);
-    fputs(sha1_to_base32(sha1), f);
+  if (w && sha1 && tth) {
+    writer_puts(w, "urn:bitprint:");
+    writer_puts(w, sha1_to_base32(sha1));
+    writer_puts(w, ".");
+    writer_puts(w, tth_to_base32(tth));
   }
 }
 
+
 static void
-print_tth(FILE *f, const struct tth *hash)
+print_sha1(struct writer *w, const struct sha1 *sha1)
 {
-  if (f && hash) {
-    fputs("urn:tree:tiger:", f);
-    fputs(tth_to_base32(hash), f);
+  if (w && sha1) {
+    writer_puts(w, "urn:sha1:");
+    writer_puts(w, sha1_to_base32(sha1));
   }
 }
 
-struct thex_context {
-  off_t filesize;
-  unsigned nodes;
-};
+static void
+print_tth(struct writer *w, const struct tth *hash)
+{
+  if (w && hash) {
+    writer_puts(w, "urn:tree:tiger:");
+    writer_puts(w, tth_to_base32(hash));
+  }
+}
 
-static int
-get_sums(int fd, struct tth *tth, struct sha1 *sha1)
+static void
+print_tiger(struct writer *w, const struct tiger_hash *hash)
 {
-  struct compat_sha1 sha1_ctx;
-  TT_CONTEXT tt_ctx;
-  struct stat sb;
+  if (w && hash) {
+    writer_puts(w, "urn:tiger:");
+    writer_puts(w, tiger_to_base32(hash));
+  }
+}
 
-  if (fstat(fd, &sb)) {
-    fprintf(stderr, "fstat(): %s\n", compat_strerror(errno));
-    return -1;
+static void
+print_filename(struct writer *w, const char *filename)
+{
+  if (filename) {
+    writer_puts(w, filename);
+    writer_puts(w, ": ");
   }
+}
 
-  if (sha1) {
-    compat_sha1_init(&sha1_ctx);
+static void
+print_result(struct writer *w, const char *filename, bool get_bitprint,
+    const struct sha1 *sha1, const struct tth *tth,
+    const struct tiger_hash *tiger)
+{
+  if (get_bitprint && tth && sha1) {
+    print_filename(w, filename);
+    print_bitprint(w, sha1, tth);
+    writer_puts(w, "\n");
+  } else {
+    if (tth) {
+      print_filename(w, filename);
+      print_tth(w, tth);
+      writer_puts(w, "\n");
+    }
+    if (sha1) {
+      print_filename(w, filename);
+      print_sha1(w, sha1);
+      writer_puts(w, "\n");
+    }
+  }
+  if (tiger) {
+    print_filename(w, filename);
+    print_tiger(w, tiger);
+    writer_puts(w, "\n");
   }
-  if (tth) {
-    tt_init(&tt_ctx);
+  if (w->tty) {
+    writer_flush(w);
   }
+}
 
-  for (;;) {
-    static uint64_t data[4 * 1024]; /* 32 KiB */
-    ssize_t ret;
+static void
+job_print(const struct options *opt, const struct job *job)
+{
+  if (opt->check) {
+    if (JOB_DONE == job->state && opt->quiet)
+      return;
+
+    print_filename(&output, job->filename);
+    writer_puts(&output, JOB_DONE == job->state ? "OK\n" :
+        job->missing ? "MISSING\n" : "FAILED\n");
+    if (output.tty) {
+      writer_flush(&output);
+    }
+    return;
+  }
 
-    ret = read(fd, data, sizeof data);
-    if (0 == ret) {
-      break;
-    } else if ((ssize_t) -1 != ret) {
-      if (sha1) {
-        compat_sha1_update(&sha1_ctx, data, (size_t) ret);
-      }
-      if (tth) {
-        tt_update(&tt_ctx, data, (size_t) ret);
-      }
-    } else if (EINTR != errno && EAGAIN != errno) {
-      fprintf(stderr, "read(): %s\n", compat_strerror(errno));
-      return -1;
+  print_result(&output, opt->quiet ? NULL : job->filename, opt->get_bitprint,
+      opt->sha1 ? &job->sha1 : NULL,
+      opt->tth ? &job->tth : NULL,
+      opt->tiger ? &job->tiger : NULL);
+  if (job->thex) {
+    print_filename(&output, opt->quiet ? NULL : job->filename);
+    writer_puts(&output, "thex:");
+    writer_puts(&output, job->thex);
+    writer_puts(&output, "\n");
+    if (output.tty) {
+      writer_flush(&output);
     }
   }
+}
+
+/**
+ * Hashes the given files on up to opt->jobs threads. With fewer files
+ * than threads, the remaining threads help with the files themselves.
+ * In the recursive mode, directories are replaced by their contents.
+ *
+ * @return 0 on success, -1 if any file could not be hashed.
+ */
+static int
+hash_files(const struct options *opt, char *filenames[], size_t n)
+{
+  struct hashcache *cache = NULL;
+  struct pool *pool;
+  unsigned workers = 1;
+  size_t i;
+  int result;
+
+  /*
+   * A single file is hashed as before. Otherwise each thread takes one
+   * file after another and, once there are none left, helps with the
+   * large files of the others.
+   */
+#ifdef HAVE_PTHREAD_SUPPORT
+  if (n > 1 || opt->recursive || opt->files_from || opt->check) {
+    workers = opt->jobs;
+  }
+#endif /* HAVE_PTHREAD_SUPPORT */
 
-  if (sha1) {
-    compat_sha1_final(&sha1_ctx, sha1);
+  pool = pool_new(opt, workers, job_print);
+  if (!pool) {
+    print_error("calloc", NULL, errno);
+    exit(EXIT_FAILURE);
   }
-  if (tth) {
-    tt_digest(&tt_ctx, tth->data);
+  for (i = 0; i < n; i++) {
+    pool_add_path(pool, filenames[i]);
   }
+  if (opt->files_from || opt->check) {
+    const char *list = opt->check ? opt->check : opt->files_from;
 
-  return 0;
-}
+    if (pool_list(pool, list)) {
+      print_error("open", list, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
 
+  if (opt->cache) {
+    cache = hashcache_open(opt->cache);
+    if (!cache) {
+      print_error("hashcache_open", opt->cache, errno);
+      exit(EXIT_FAILURE);
+    }
+  } else if (opt->xattr) {
+    cache = hashcache_xattr();
+    if (!cache) {
+      print_error("hashcache_xattr", NULL, errno);
+      exit(EXIT_FAILURE);
+    }
+  }
 
-static void
-print_filename(FILE *f, const char *filename)
-{
-  if (filename) {
-    fputs(filename, f);
-    fputs(": ", f);
+  hash_pool(pool, opt, cache);
+
+  writer_flush(&output);
+  hashcache_close(cache);
+
+  if (opt->check) {
+    uint64_t ok, failed, missing;
+
+    pool_checked(pool, &ok, &failed, &missing);
+    fprintf(stderr, "%" PRIu64 " OK, %" PRIu64 " FAILED, %" PRIu64
+      " MISSING\n", ok, failed, missing);
   }
+  result = pool_failed(pool) ? -1 : 0;
+  pool_free(pool);
+  return result;
 }
 
-static void
-print_result(FILE *f, const char *filename, bool get_bitprint,
-    const struct sha1 *sha1, const struct tth *tth)
+/**
+ * Verifies "filename" against the THEX tree in opt->tree, which must be
+ * that of a file of the same size. Each node of the bottom level is the
+ * root of a segment of the file, which are hashed on opt->jobs threads.
+ * The corrupt byte ranges are printed.
+ *
+ * @return 0 if all segments asked for are intact, -1 otherwise.
+ */
+static int
+verify_tree(const struct options *opt, const char *filename)
 {
-  if (get_bitprint && tth && sha1) {
-    print_filename(f, filename);
-    print_bitprint(f, sha1, tth);
-    fputs("\n", f);
-  } else {
-    if (tth) {
-      print_filename(f, filename);
-      print_tth(f, tth);
-      fputs("\n", f);
+  uint64_t first, end, i;
+  uint64_t ok = 0, bad = 0, unchecked = 0;
+  struct verify v;
+  struct stat sb;
+  int fd, result = 0;
+
+  switch (verify_load(&v, opt->tree)) {
+  case VERIFY_OK:
+    break;
+  case VERIFY_NO_TREE:
+    fprintf(stderr, "Error: There is no THEX tree in \"%s\".\n", opt->tree);
+    verify_free(&v);
+    return -1;
+  default:
+    print_error("read", opt->tree, errno);
+    verify_free(&v);
+    return -1;
+  }
+
+  fd = open(filename, O_RDONLY, 0);
+  if (fd < 0 || fstat(fd, &sb)) {
+    print_error(fd < 0 ? "open" : "fstat", filename, errno);
+    verify_free(&v);
+    return -1;
+  }
+
+  switch (verify_match(&v, sb.st_size)) {
+  case VERIFY_OK:
+    break;
+  case VERIFY_MISMATCH:
+    fprintf(stderr, "Error: The THEX tree does not match the size of "
+        "\"%s\".\n", filename);
+    result = -1;
+    goto done;
+  default:
+    fprintf(stderr, "Error: The THEX tree in \"%s\" is corrupt.\n",
+        opt->tree);
+    result = -1;
+    goto done;
+  }
+
+  first = 0;
+  end = v.count;
+  if (opt->range) {
+    if (opt->from > opt->to || opt->from >= MAX(1, v.size)) {
+      fprintf(stderr, "Error: The range of -b is not within \"%s\".\n",
+          filename);
+      result = -1;
+      goto done;
     }
-    if (sha1) {
-      print_filename(f, filename);
-      print_sha1(f, sha1);
-      fputs("\n", f);
+    first = opt->from / v.segment;
+    end = MIN(v.count, opt->to / v.segment + 1);
+  }
+
+  if (verify_segments(&v, fd, first, end, opt->jobs, opt->stop)) {
+    print_error("pread", filename, errno);
+    result = -1;
+    goto done;
+  }
+
+  /* Adjacent corrupt segments are reported as one range */
+  for (i = first; i < end; i++) {
+    if (TT_SEGMENT_BAD == v.state[i]) {
+      uint64_t j = i;
+
+      while (j + 1 < end && TT_SEGMENT_BAD == v.state[j + 1]) {
+        j++;
+      }
+      bad += j - i + 1;
+      print_filename(&output, filename);
+      if (0 == v.size) {
+        writer_puts(&output, "FAILED\n");
+      } else {
+        char buf[64];
+
+        snprintf(buf, sizeof buf, "FAILED %" PRIu64 "-%" PRIu64 "\n",
+          i * v.segment, MIN(v.size, (j + 1) * v.segment) - 1);
+        writer_puts(&output, buf);
+      }
+      i = j;
+    } else if (TT_SEGMENT_OK == v.state[i]) {
+      ok++;
+    } else {
+      unchecked++;
     }
   }
+  if (0 == bad && !opt->quiet) {
+    print_filename(&output, filename);
+    writer_puts(&output, "OK\n");
+  }
+  writer_flush(&output);
+
+  fprintf(stderr, "%" PRIu64 " OK, %" PRIu64 " FAILED, %" PRIu64
+    " NOT CHECKED segments of %" PRIu64 " bytes\n", ok, bad, unchecked,
+    v.segment);
+  if (bad > 0) {
+    result = -1;
+  }
+
+done:
+  close(fd);
+  verify_free(&v);
+  return result;
 }
 
+#ifdef HAVE_GETOPT_LONG
+static const struct option long_options[] = {
+  { "bytes",        required_argument,  NULL, 'b' },
+  { "cache",        required_argument,  NULL, 'k' },
+  { "check",        required_argument,  NULL, 'C' },
+  { "dereference",  no_argument,        NULL, 'L' },
+  { "files-from",   required_argument,  NULL, 'F' },
+  { "jobs",         required_argument,  NULL, 'j' },
+  { "kernels",      no_argument,        NULL, 'V' },
+  { "nocache",      no_argument,        NULL, 'N' },
+  { "null",         no_argument,        NULL, '0' },
+  { "queue-depth",  required_argument,  NULL, 'Q' },
+  { "recursive",    no_argument,        NULL, 'r' },
+  { "stop",         no_argument,        NULL, 'E' },
+  { "thex",         required_argument,  NULL, 'X' },
+  { "tree",         required_argument,  NULL, 'R' },
+  { "unordered",    no_argument,        NULL, 'u' },
+  { "xattr",        no_argument,        NULL, 'x' },
+  { NULL,           0,                  NULL, 0 }
+};
+#define GETOPT(argc, argv, optstring) \
+  getopt_long((argc), (argv), (optstring), long_options, NULL)
+#else
+#define GETOPT(argc, argv, optstring) getopt((argc), (argv), (optstring))
+#endif /* HAVE_GETOPT_LONG */
+
 static void
 usage(int status)
 {
-  fprintf(stderr, "Usage: bitter [-h|-c|-S|-T] [FILE ...]\n");
+  fprintf(stderr,
+    "Usage: bitter [-h|-c|-S|-T] [-t] [-j N] [-u] [-r [-L]] [-Q N] [-N]\n"
+    "              [-F LIST [-0]] [-k DB|-x|-X DEPTH] [FILE ...]\n"
+    "       bitter -C LIST [-j N] [-u] [-q] [-Q N] [-N]\n"
+    "       bitter -R TREE [-j N] [-q] [-E] [-b FROM-TO] FILE\n");
   fprintf(stderr, "   -h: Show this help.\n");
   fprintf(stderr, "   -v: Show version information.\n");
+  fprintf(stderr, "   -V: Show the selected hash kernels (--kernels).\n");
   fprintf(stderr, "   -S: Calculate the SHA1 only.\n");
   fprintf(stderr, "   -T: Calculate the TTH only.\n");
-  fprintf(stderr, "   -q: Do not print the filename.\n");
+  fprintf(stderr, "   -t: Calculate the Tiger hash of the whole file only,\n"
+                  "       or in addition to -S and -T.\n");
+  fprintf(stderr, "   -j N: Hash with N threads, several files at once;\n"
+                  "         0 uses all available CPUs (--jobs).\n");
+  fprintf(stderr, "   -u: Print the results as they are ready rather than\n"
+                  "       in the order of the files (--unordered).\n");
+  fprintf(stderr, "   -r: Hash the regular files in directories recursively\n"
+                  "       (--recursive).\n");
+  fprintf(stderr, "   -L: Follow symbolic links with -r (--dereference).\n");
+  fprintf(stderr, "   -F LIST: Hash the files listed in LIST, one per line,\n"
+                  "            or the standard input for \"-\" (--files-from).\n");
+  fprintf(stderr, "   -0: The files in LIST are separated by NUL characters\n"
+                  "       (--null).\n");
+  fprintf(stderr, "   -Q N: Keep up to N reads in flight with io_uring,\n"
+                  "         0 disables it (--queue-depth, default %u).\n",
+    URING_DEPTH_DEFAULT);
+  fprintf(stderr, "   -N: Keep the files out of the page cache (--nocache).\n");
+  fprintf(stderr, "   -k DB: Keep the SHA-1 and TTH of the files in the\n"
+                  "          database DB and skip unchanged files (--cache).\n");
+  fprintf(stderr, "   -x: Keep them in the attribute \"user.bitprint\" of\n"
+                  "       each file instead (--xattr).\n");
+  fprintf(stderr, "   -X DEPTH: Print the THEX tree of up to DEPTH levels,\n"
+                  "             from 1 to %u, too (--thex).\n",
+    TT_THEX_DEPTH_MAX);
+  fprintf(stderr, "   -C LIST: Check the files against the results in LIST\n"
+                  "            and print OK, FAILED or MISSING (--check).\n");
+  fprintf(stderr, "   -R TREE: Verify FILE against the THEX tree in TREE, as\n"
+                  "            printed with -X, and print the corrupt byte\n"
+                  "            ranges (--tree).\n");
+  fprintf(stderr, "   -E: Stop at the first corrupt segment (--stop).\n");
+  fprintf(stderr, "   -b FROM-TO: Only verify the segments with these bytes\n"
+                  "               (--bytes).\n");
+  fprintf(stderr, "   -q: Do not print the filename, with -C or -R only\n"
+                  "       print the files or ranges which are not OK.\n");
   fprintf(stderr, "   -c sha1: Convert SHA-1 representation.\n");
   fprintf(stderr, "You may specify multiple filenames or none\n");
-  fprintf(stderr, "to read from the standard input.\n\n");
+  fprintf(stderr, "to read from the standard input.\n");
+  fprintf(stderr, "Set %s to pin kernels, e.g. \"tiger=scalar\".\n\n",
+    KERNEL_ENV);
   exit(status);
 }
 
 int 
 main(int argc, char *argv[])
 {
-  static struct tth *tth;
-  static struct sha1 *sha1;
+  static struct options opt;
   static bool get_bitprint = true,
               get_sha1 = false,
               get_tth = false,
-              quiet = false;
-  int i, c;
+              get_tiger = false;
+  int c;
+
+  kernels_init();
 
-  while (-1 != (c = getopt(argc, argv, "c:hvqST"))) {
+  opt.jobs = 1;
+  opt.depth = URING_DEPTH_DEFAULT;
+  opt.delim = '\n';
+
+  while (-1 != (c = GETOPT(argc, argv, "0b:c:C:EF:hj:k:LNvqQ:rR:STtuVxX:"))) {
     switch (c) {
     case 'h':
       usage(EXIT_SUCCESS);
@@ -255,6 +537,42 @@ main(int argc, char *argv[])
       get_tth  = 'T' == c;
       break;
 
+    case 't':
+      get_tiger = true;
+      break;
+
+    case 'j':
+      {
+        uint32_t n;
+        char *ep;
+        int error;
+
+        n = parse_uint32(optarg, &ep, 10, &error);
+        if (error || '\0' != *ep || n > JOBS_MAX) {
+          fprintf(stderr, "Error: -j expects a number from 0 to %u.\n",
+            JOBS_MAX);
+          usage(EXIT_FAILURE);
+        }
+        opt.jobs = n > 0 ? n : MIN(cpu_count(), JOBS_MAX);
+      }
+      break;
+
+    case 'Q':
+      {
+        uint32_t n;
+        char *ep;
+        int error;
+
+        n = parse_uint32(optarg, &ep, 10, &error);
+        if (error || '\0' != *ep || n > URING_DEPTH_MAX) {
+          fprintf(stderr, "Error: -Q expects a number from 0 to %u.\n",
+            URING_DEPTH_MAX);
+          usage(EXIT_FAILURE);
+        }
+        opt.depth = n;
+      }
+      break;
+
     case 'c':
       {
         const char *s;
@@ -295,8 +613,90 @@ main(int argc, char *argv[])
       exit(EXIT_SUCCESS);
       break;
 
+    case 'V':
+      kernels_report(stdout);
+      exit(EXIT_SUCCESS);
+      break;
+
     case 'q':
-      quiet = true;
+      opt.quiet = true;
+      break;
+
+    case 'N':
+      opt.nocache = true;
+      break;
+
+    case 'u':
+      opt.unordered = true;
+      break;
+
+    case 'r':
+      opt.recursive = true;
+      break;
+
+    case 'L':
+      opt.follow = true;
+      break;
+
+    case 'F':
+      opt.files_from = optarg;
+      break;
+
+    case '0':
+      opt.delim = '\0';
+      break;
+
+    case 'k':
+      opt.cache = optarg;
+      break;
+
+    case 'C':
+      opt.check = optarg;
+      break;
+
+    case 'x':
+      opt.xattr = true;
+      break;
+
+    case 'R':
+      opt.tree = optarg;
+      break;
+
+    case 'E':
+      opt.stop = true;
+      break;
+
+    case 'b':
+      {
+        char *ep;
+        int error;
+
+        opt.from = parse_uint64(optarg, &ep, 10, &error);
+        if (!error && '-' == *ep) {
+          opt.to = parse_uint64(&ep[1], &ep, 10, &error);
+        }
+        if (error || '\0' != *ep || opt.from > opt.to) {
+          fprintf(stderr, "Error: -b expects a range of bytes FROM-TO.\n");
+          usage(EXIT_FAILURE);
+        }
+        opt.range = true;
+      }
+      break;
+
+    case 'X':
+      {
+        uint32_t n;
+        char *ep;
+        int error;
+
+        n = parse_uint32(optarg, &ep, 10, &error);
+        if (error || '\0' != *ep || n < 1 || n > TT_THEX_DEPTH_MAX) {
+          fprintf(stderr, "Error: -X expects a number from 1 to %u.\n",
+            TT_THEX_DEPTH_MAX);
+          usage(EXIT_FAILURE);
+        }
+        opt.thex = n;
+      }
       break;
 
     default:
@@ -306,52 +706,91 @@ main(int argc, char *argv[])
   argc -= optind;
   argv += optind;
 
+  if (opt.cache && opt.xattr) {
+    fprintf(stderr,
+        "Error: The options -k and -x are mutually exclusive.\n");
+    usage(EXIT_FAILURE);
+  }
+
+  if (get_tiger && get_bitprint) {
+    get_bitprint = false; /* -t alone selects the Tiger hash only */
+  }
   if (get_bitprint) {
     get_sha1 = true;
     get_tth = true;
   }
-  if (get_sha1) {
-    static struct sha1 sha1_buf;
-    sha1 = &sha1_buf;
+  opt.get_bitprint = get_bitprint;
+  opt.sha1 = get_sha1;
+  opt.tth = get_tth;
+  opt.tiger = get_tiger;
+
+  /* A cached file is not read, so there would be no tree */
+  if (opt.thex > 0 && (!opt.tth || opt.cache || opt.xattr || opt.check)) {
+    fprintf(stderr,
+        "Error: The option -X requires the TTH and cannot be combined\n"
+        "       with -k, -x or -C.\n");
+    usage(EXIT_FAILURE);
   }
-  if (get_tth) {
-    static struct tth tth_buf;
-    tth = &tth_buf;
+
+  output.fd = STDOUT_FILENO;
+  output.tty = isatty(STDOUT_FILENO);
+
+  if (
+    opt.check &&
+    (argc > 0 || opt.files_from || opt.recursive || opt.cache || opt.xattr)
+  ) {
+    fprintf(stderr,
+        "Error: The option -C cannot be combined with files to hash,\n"
+        "       -F, -r, -k or -x.\n");
+    usage(EXIT_FAILURE);
   }
 
-  if (0 == argc) {
-    if (0 == get_sums(STDIN_FILENO, tth, sha1)) {
-      print_result(stdout, NULL, get_bitprint, sha1, tth);
-      exit(EXIT_SUCCESS);
-    } else {
-      fprintf(stderr, "FAILURE!\n");
-      exit(EXIT_FAILURE);
+  if (opt.tree) {
+    if (
+      1 != argc || opt.files_from || opt.recursive || opt.cache ||
+      opt.xattr || opt.check || opt.thex
+    ) {
+      fprintf(stderr,
+          "Error: The option -R takes a single file and cannot be\n"
+          "       combined with -F, -r, -k, -x, -C or -X.\n");
+      usage(EXIT_FAILURE);
     }
+    exit(verify_tree(&opt, argv[0]) ? EXIT_FAILURE : EXIT_SUCCESS);
+  } else if (opt.stop || opt.range) {
+    fprintf(stderr, "Error: The options -E and -b require -R.\n");
+    usage(EXIT_FAILURE);
   }
 
-  for (i = 0; i < argc; i++) {
-    const char *filename;
-    int fd;
+  if (0 == argc && opt.recursive && !opt.files_from) {
+    static char *dot[] = { ".", NULL };
 
-    filename = argv[i];
-    fd = open(filename, O_RDONLY, 0);
-    if (fd < 0) {
-      fprintf(stderr, "open(\"%s\"): %s\n", filename, compat_strerror(errno));
-      exit(EXIT_FAILURE);
-    }
-
-#ifdef POSIX_FADV_SEQUENTIAL
-     posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
-#endif  /* POSIX_FADV_SEQUENTIAL */
+    argc = 1;
+    argv = dot;
+  }
 
-    if (0 == get_sums(fd, tth, sha1)) {
-      print_result(stdout, quiet ? NULL : filename, get_bitprint, sha1, tth);
+  if (0 == argc && !opt.files_from && !opt.check) {
+    static struct job job;
+    struct hasher *h;
+
+    h = hasher_new(&opt, NULL, opt.jobs, true);
+    if (
+      0 == hasher_sums(h, STDIN_FILENO, NULL,
+              opt.tth ? &job.tth : NULL, opt.sha1 ? &job.sha1 : NULL,
+              opt.tiger ? &job.tiger : NULL)
+    ) {
+      if (opt.thex > 0) {
+        job.thex = hasher_thex(h);
+      }
+      job_print(&opt, &job);
+      writer_flush(&output);
+      exit(EXIT_SUCCESS);
+    } else {
+      fprintf(stderr, "FAILURE!\n");
+      exit(EXIT_FAILURE);
     }
-    close(fd);
-    fd = -1;
   }
 
-  return 0;
+  exit(hash_files(&opt, argv, argc) ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 
 /* vi: set ai et sts=2 sw=2 cindent: */